@@ -32,8 +32,8 @@ FPS = 30 # Taxa de quadros de 30 FPS // Diminuir o FPS a medida que aumenta a qu
 MOSTRAR_PREVIEW = True
 
 # Cabeçalho e unidades
-CAMPOS = ["Tempo", "XGPS", "YGPS", "ZGPS", "Theta", "Phi"]
-UNIDADES = ["Segundos", "m", "m", "m", "deg", "deg"]
+CAMPOS = ["Tempo", "XGPS", "YGPS", "ZGPS", "Theta", "Phi", "TempoPico"]
+UNIDADES = ["Segundos", "m", "m", "m", "deg", "deg", "us"]
 
 # Tempo mínimo antes de permitir STOP
 MIN_TIME_STOP = 45 # Mantido em 45 segundos
@@ -101,7 +101,7 @@ class HUDData:
         with self.lock:
             self.data = hud_dict.copy() if hud_dict else None
             if hud_dict and 'time' in hud_dict:
-                # Extrair timestamp do Pico (formato: MM:SS.ss ou HH:MM:SS)
+                # Extrair timestamp do Pico (formato: HH:MM:SS.mmm ou HH:MM:SS)
                 try:
                     tempo_str = hud_dict['time']
                     # Tentar suportar vários formatos; aqui simplificamos:
@@ -155,13 +155,15 @@ def thread_leitura_serial(ser, data_buffer, hud_data, stop_event, stats):
                         dados = linha.replace("DATA,", "")
                         valores = dados.split(',')
 
-                        if len(valores) == 6:
+                        # Firmware antigo: 6 valores, sem o instante do relógio do Pico
+                        if len(valores) in (6, 7):
                             # Usar tempo do Pico, não do Pi
-                            tempo, xgps, ygps, zgps, theta, phi = valores
+                            tempo, xgps, ygps, zgps, theta, phi = valores[:6]
+                            tempo_pico = valores[6] if len(valores) == 7 else ''
                             # Validar que é número
                             try:
                                 float(tempo)
-                                linha_formatada = f"{tempo}\t{xgps}\t{ygps}\t{zgps}\t{theta}\t{phi}"
+                                linha_formatada = f"{tempo}\t{xgps}\t{ygps}\t{zgps}\t{theta}\t{phi}\t{tempo_pico}"
                                 data_buffer.add(linha_formatada)
                                 stats['data_recebidas'] += 1
                             except ValueError:
@@ -170,7 +172,7 @@ def thread_leitura_serial(ser, data_buffer, hud_data, stop_event, stats):
                     # Dados HUD - atualizar overlay
                     elif linha.startswith("HUD"):
                         partes = linha.split('|')
-                        # esperado: HUD|time|alt|vel|gz|status
+                        # esperado: HUD|time|alt|vel|gz|status[|vs[|t_us]]
                         if len(partes) >= 6:
                             novo_hud = {
                                 'time': partes[1],
@@ -179,6 +181,10 @@ def thread_leitura_serial(ser, data_buffer, hud_data, stop_event, stats):
                                 'g_z': partes[4],
                                 'status': partes[5]
                             }
+                            if len(partes) >= 7:
+                                novo_hud['vertical_speed'] = partes[6]
+                            if len(partes) >= 8:
+                                novo_hud['pico_us'] = partes[7]
                             hud_data.update(novo_hud)
                             stats['hud_recebidas'] += 1
 
@@ -268,7 +274,7 @@ def draw_overlay(frame, hud_dict, awaiting_decolagem_text=None):
         return frame
 
     # ============ TEMPO - CENTRO SUPERIOR ============
-    tempo = hud_dict.get('time', '--:--:--')
+    tempo = hud_dict.get('time', '--:--:--').split('.')[0]
     (tw, th), _ = cv2.getTextSize(tempo, font, 0.75, 2)
     cv2.putText(frame, tempo, (w//2 - tw//2, 40), font, 0.75,
                 text_color, 2, cv2.LINE_AA)
@@ -288,6 +294,14 @@ def draw_overlay(frame, hud_dict, awaiting_decolagem_text=None):
     cv2.putText(frame, "m", (alt_x + 10, alt_y + 40), font, 0.5,
                 text_color, 1, cv2.LINE_AA)
 
+    # Velocidade vertical (variômetro), abaixo da altitude
+    vs_value = hud_dict.get('vertical_speed')
+    if vs_value is not None:
+        cv2.putText(frame, "VS", (alt_x, alt_y + 80), font, 0.35,
+                    text_color, 1, cv2.LINE_AA)
+        cv2.putText(frame, f"{vs_value} m/s", (alt_x, alt_y + 105), font, 0.6,
+                    text_color, 1, cv2.LINE_AA)
+
     # ============ VELOCIDADE (CAS) - DIREITA ============
     vel_value = hud_dict.get('velocity', '---')
     vel_x = w - 90
@@ -1,14 +1,47 @@
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "mpu6500.h"
 #include "bme680_custom.h"
 #include "GPS_neo_6.h"
+#include "agendador.h"
+#include "seqlock.h"
+#include "desempenho.h"
+#include "matematica_rapida.h"
+#include "decimador.h"
+#include "vibracao.h"
+#include "kalman_vertical.h"
+#include "navegacao_estimada.h"
+#include "fluxo_amostras.h"
+#include "janela_movel.h"
+
+#ifdef AERO_DUAL_CORE
+#include "pico/multicore.h"
+#endif
+#ifdef AERO_AHRS
+#include "ahrs.h"
+#endif
+#ifdef AERO_CALIBRACAO_FLASH
+#include "calibracao_flash.h"
+#include "pico/flash.h"
+#endif
+#include "pico/stdio_usb.h"
 
 #define GPS_FILTER_SIZE 5
-#define GPS_MOVEMENT_THRESHOLD 0.5  // Ignorar movimentos menores que 50cm
-#define G_ACCEL 9.81  // Aceleração gravitacional em m/s²
+#define BARO_JANELA 5  // Altitudes válidas do BME680 para a proteção contra leituras nulas
+#define GPS_MOVEMENT_THRESHOLD 0.5f  // Ignorar movimentos menores que 50cm
+
+// Períodos das tarefas do agendador
+#define PERIODO_AQUISICAO_US    10000    // 100 Hz (IMU; BME680 coletado quando pronto)
+#define PERIODO_GPS_US          50000    // Buffer circular de RX guarda ~1 s de NMEA
+#define PERIODO_TELEMETRIA_US   20000    // 50 Hz
+#define PERIODO_DIAGNOSTICO_US  5000000
+#define PERIODO_VIBRACAO_US     20000    // Um eixo da FFT por execução, em ciclos livres
+
+// Saídas DATA/HUD: a IMU amostrada em taxa alta é decimada para a taxa da telemetria
+#define TAXA_TELEMETRIA_HZ      (1000000 / PERIODO_TELEMETRIA_US)
 
 // Estados do planador
 typedef enum {
@@ -18,59 +51,29 @@ typedef enum {
 } drone_status_t;
 
 typedef struct {
-    double x_buffer[GPS_FILTER_SIZE];
-    double y_buffer[GPS_FILTER_SIZE];
-    double z_buffer[GPS_FILTER_SIZE];
-    int index;
-    int count;
-} gps_filter_t;
-
-typedef struct {
-    uint32_t gps_time;
-    double latitude;
-    double longitude;
-    double altitude_gps;
-    double altitude_bme;
-    double velocity_cas;
-    double accel_x;
-    double accel_y;
-    double accel_z;
-    double theta;
-    double phi;
+    uint32_t gps_time_ms;   // Hora de Brasília do instante da saída, ms desde 0h
+    uint64_t tempo_us;      // Instante da saída no relógio do Pico (time_us_64)
+    float latitude;
+    float longitude;
+    float altitude_gps;
+    float altitude_bme;
+    float altitude;         // Canal vertical filtrado
+    float vertical_speed;   // m/s, positiva subindo
+    float velocity_cas;
+    float accel_x;
+    float accel_y;
+    float accel_z;
+    float theta;
+    float phi;
     drone_status_t status;
     uint8_t gps_sats;
 } hud_data_t;
 
-gps_filter_t gps_filter = {0};
+janela_movel_t janela_gps;  // Z bruto do GPS (média móvel)
 hud_data_t hud_data = {0};
 
-void gps_filter_add(double x, double y, double z) {
-    gps_filter.x_buffer[gps_filter.index] = x;
-    gps_filter.y_buffer[gps_filter.index] = y;
-    gps_filter.z_buffer[gps_filter.index] = z;
-    
-    gps_filter.index = (gps_filter.index + 1) % GPS_FILTER_SIZE;
-    if (gps_filter.count < GPS_FILTER_SIZE) {
-        gps_filter.count++;
-    }
-}
-
-void gps_filter_get_average(double *x, double *y, double *z) {
-    double sum_x = 0, sum_y = 0, sum_z = 0;
-    
-    for (int i = 0; i < gps_filter.count; i++) {
-        sum_x += gps_filter.x_buffer[i];
-        sum_y += gps_filter.y_buffer[i];
-        sum_z += gps_filter.z_buffer[i];
-    }
-    
-    *x = sum_x / gps_filter.count;
-    *y = sum_y / gps_filter.count;
-    *z = sum_z / gps_filter.count;
-}
-
 // Calcular CAS (Calibrated Airspeed) a partir de pressão dinâmica
-double calcular_cas(float pressao_atual, float pressao_base) {
+float calcular_cas(float pressao_atual, float pressao_base) {
     // Pressão dinâmica = pressão_atual - pressao_base
     float pressao_dinamica = (pressao_atual - pressao_base) * 100.0f;  // Pa
     
@@ -82,38 +85,38 @@ double calcular_cas(float pressao_atual, float pressao_base) {
     if (pressao_dinamica < 0.5f) pressao_dinamica = 0;
     if (pressao_dinamica < 0) pressao_dinamica = 0;
     
-    float cas_ms = sqrt((2.0f * pressao_dinamica) / densidade_ar);
+    float cas_ms = mat_sqrt((2.0f * pressao_dinamica) / densidade_ar);
     float cas_kmh = cas_ms * 3.6f;
     
-    return (double)cas_kmh;
+    return cas_kmh;
 }
 
 // Variável para guardar o status anterior (para hysteresis)
 static drone_status_t status_anterior = ATT;
 
 // Determinar status do planador com parâmetro de tempo + hysteresis
-drone_status_t determinar_status(double altitude, double velocidade, uint32_t tempo_voo) {
+drone_status_t determinar_status(float altitude, float velocidade, uint32_t tempo_voo) {
     // LND (Em Solo): altitude < 2m E velocidade < 0.5 km/h
-    if (altitude < 2.0 && velocidade < 0.5) {
+    if (altitude < 2.0f && velocidade < 0.5f) {
         status_anterior = LND;
         return LND;
     }
     
     // DPL (Em Voo): altitude > 5m E tempo > 60 segundos E velocidade > 0.5 km/h
-    if (altitude > 5.0 && tempo_voo > 60 && velocidade > 0.5) {
+    if (altitude > 5.0f && tempo_voo > 60 && velocidade > 0.5f) {
         status_anterior = DPL;
         return DPL;
     }
     
     // ATT (Acoplado): zona intermediária com hysteresis
     // Se estava em LND, precisa subir para > 3m ou velocidade > 1 km/h para sair
-    if (status_anterior == LND && (altitude > 3.0 || velocidade > 1.0)) {
+    if (status_anterior == LND && (altitude > 3.0f || velocidade > 1.0f)) {
         status_anterior = ATT;
         return ATT;
     }
     
     // Se estava em DPL, precisa descer para < 3m ou velocidade < 0.5 km/h para sair
-    if (status_anterior == DPL && (altitude < 3.0 || velocidade < 0.5)) {
+    if (status_anterior == DPL && (altitude < 3.0f || velocidade < 0.5f)) {
         status_anterior = ATT;
         return ATT;
     }
@@ -133,65 +136,581 @@ const char* status_to_string(drone_status_t status) {
 
 // Enviar dados para HUD (sobreposição de vídeo)
 void enviar_hud(hud_data_t *hud) {
-    // Formato: HUD|TIME|ALT|CAS|G_Z|SAT
-    // Exemplo: HUD|19:03:44|424.70|15.5|1.02|09
+    // Formato: HUD|TIME|ALT|CAS|G_Z|STATUS|VS|T_US
+    // Exemplo: HUD|19:03:44.120|424.7|15.5|1.02|DPL|+1.3|81234567
     
-    uint32_t time_s = hud->gps_time;
+    uint32_t time_s = hud->gps_time_ms / 1000;
     uint8_t hours = (time_s / 3600) % 24;
     uint8_t minutes = (time_s / 60) % 60;
     uint8_t seconds = time_s % 60;
+    uint16_t millis = hud->gps_time_ms % 1000;
     
     // Fator de carga em Z (em múltiplos de g)
-    double g_z = hud->accel_z / G_ACCEL;
+    float g_z = hud->accel_z / GRAVIDADE;
     
-    printf("HUD|%02d:%02d:%02d|%.1f|%.1f|%.2f|%s\n",
-           hours, minutes, seconds,
-           hud->altitude_bme,
-           hud->velocity_cas,
-           g_z,
-           status_to_string(hud->status));
+    printf("HUD|%02d:%02d:%02d.%03d|%.1f|%.1f|%.2f|%s|%+.1f|%llu\n",
+           hours, minutes, seconds, millis,
+           (double)hud->altitude,
+           (double)hud->velocity_cas,
+           (double)g_z,
+           status_to_string(hud->status),
+           (double)hud->vertical_speed,
+           (unsigned long long)hud->tempo_us);
 }
 
 // Salvar dados brutos em arquivo (para análise pós-voo)
-void salvar_dados_arquivo(double xgps, double ygps, double zgps, float theta, float phi, uint32_t tempo_gps) {
-    // Formato original: DATA,tempo_segundos,X,Y,Z,theta,phi
-    printf("DATA,%u,%.2f,%.2f,%.2f,%.2f,%.2f\n",
-           tempo_gps, xgps, ygps, zgps, theta, phi);
+void salvar_dados_arquivo(float xgps, float ygps, float zgps, float theta, float phi,
+                          uint32_t tempo_ms, uint64_t tempo_us) {
+    // Formato: DATA,tempo_segundos,X,Y,Z,theta,phi,tempo_pico_us
+    // tempo_segundos: hora de Brasília com ms; tempo_pico_us: time_us_64 da amostra
+    printf("DATA,%lu.%03lu,%.2f,%.2f,%.2f,%.2f,%.2f,%llu\n",
+           (unsigned long)(tempo_ms / 1000), (unsigned long)(tempo_ms % 1000),
+           (double)xgps, (double)ygps, (double)zgps, (double)theta, (double)phi,
+           (unsigned long long)tempo_us);
+}
+
+// Estado compartilhado entre as tarefas
+static struct bme680_dev sensor;
+static uint16_t periodo_bme;
+static float pressao_base;
+static bme680_leitor_t leitor_bme;
+
+// Fluxos com carimbo de tempo entre a aquisição (core1 no modo dual-core),
+// o GPS e a telemetria (core0)
+enum { IMU_THETA, IMU_PHI, IMU_ACCEL_Z, IMU_ACEL_X_TERRA, IMU_ACEL_Y_TERRA, IMU_GUINADA, NUM_VALORES_IMU };
+enum { BARO_ALTITUDE, BARO_PRESSAO, NUM_VALORES_BARO };
+enum { VERT_ALTITUDE, VERT_VELOCIDADE, NUM_VALORES_VERT };
+enum { GPS_X, GPS_Y, GPS_Z, NUM_VALORES_GPS };
+
+static fluxo_t fluxo_imu = FLUXO("IMU", NUM_VALORES_IMU, true, (1u << IMU_PHI) | (1u << IMU_GUINADA));
+static fluxo_t fluxo_baro = FLUXO("BARO", NUM_VALORES_BARO, true, 0);
+static fluxo_t fluxo_vertical = FLUXO("VERT", NUM_VALORES_VERT, true, 0);
+static fluxo_t fluxo_gps = FLUXO("GPS", NUM_VALORES_GPS, false, 0);  // Fixes esparsos: retenção
+
+// Todos os fluxos num mesmo instante, com a idade de cada um
+enum { IDADE_IMU, IDADE_BARO, IDADE_VERT, IDADE_GPS, NUM_IDADES };
+
+typedef struct {
+    float imu[NUM_VALORES_IMU];
+    float baro[NUM_VALORES_BARO];
+    float vertical[NUM_VALORES_VERT];
+    float gps[NUM_VALORES_GPS];
+    uint32_t idade_us[NUM_IDADES];  // UINT32_MAX: fluxo ainda sem amostras
+} estado_alinhado_t;
+
+// Estado da fusão, na taxa da IMU. O fluxo da IMU recebe a versão decimada,
+// carimbada no centro da janela do FIR.
+#ifdef AERO_AHRS
+static ahrs_t ahrs;
+static bool ahrs_alinhado = false;
+
+// Canais do decimador: gravidade estimada (x, y, z), accel_z e aceleração
+// horizontal no referencial da Terra (x, y). Os ângulos saem da gravidade
+// só na taxa da telemetria.
+#define CANAIS_DECIMADOR 6
+#else
+static float theta_fusao = 0.0f;
+static float phi_fusao = 0.0f;
+
+// Canais do decimador: theta, phi, accel_z
+#define CANAIS_DECIMADOR 3
+#endif
+static decimador_t decimador_imu;
+static uint32_t atraso_decimador_us;
+
+// A telemetria lê os fluxos neste atraso em relação ao relógio, calculado
+// na inicialização: o atraso de grupo do decimador, um período de saída
+// (fase da decimação) e um de aquisição (lote ainda na FIFO), para a IMU
+// sair sempre interpolada; fluxos mais lentos saem retidos, com a idade.
+static uint32_t atraso_alinhamento_us;
+static uint64_t tempo_ultima_imu = 0;
+
+// Espectro de vibração: analisado no núcleo da aquisição, impresso pelo
+// diagnóstico
+static vibracao_resultado_t vibracao = {0};
+static vibracao_resultado_t vibracao_publicada = {0};
+static seqlock_t vibracao_lock = {0};
+
+// Canal vertical, propagado na taxa da IMU no núcleo da aquisição
+static kalman_vertical_t vertical;
+
+// Posição horizontal entre os fixes do RMC, no núcleo da telemetria. Sem
+// AHRS a aceleração horizontal fica em zero e só a velocidade do RMC é
+// extrapolada.
+static navegacao_estimada_t navegacao;
+
+static absolute_time_t t_anterior;
+static uint32_t leituras_bme = 0;
+static float altitude_bme = 0.0f;
+static janela_movel_t janela_baro;  // Últimas altitudes válidas
+static float pressao_atual = 0.0f;
+
+// Ciclos de clock por execução, para comparar código no flash e na SRAM
+static medidor_ciclos_t medidor_aquisicao = MEDIDOR_CICLOS("AQ");
+static medidor_ciclos_t medidor_gps = MEDIDOR_CICLOS("GPS");
+
+// Etapas da aquisição e da fusão (espera do barramento + processamento)
+static medidor_ciclos_t medidor_imu = MEDIDOR_CICLOS("IMU");
+static medidor_ciclos_t medidor_baro = MEDIDOR_CICLOS("BARO");
+static medidor_ciclos_t medidor_telemetria = MEDIDOR_CICLOS("TLM");
+static medidor_ciclos_t medidor_fusao = MEDIDOR_CICLOS("FUSAO");    // Por amostra da IMU
+static medidor_ciclos_t medidor_decimador = MEDIDOR_CICLOS("DEC");  // Por amostra da IMU
+static medidor_ciclos_t medidor_vertical = MEDIDOR_CICLOS("VERT");  // Por amostra da IMU
+static medidor_ciclos_t medidor_vibracao = MEDIDOR_CICLOS("VIB");
+
+static uint32_t contador_captura = 0;  // Contador de capturas GPS válidas
+
+#ifdef AERO_DUAL_CORE
+static agendador_t agendador_aquisicao;  // core1
+#endif
+static agendador_t agendador;            // core0
+
+// Proteção: leitura nula vira a mediana das últimas válidas (um valor
+// válido isolado perto do glitch não é retido sozinho)
+static void AERO_RAM_FUNC(atualizar_altitude)(float alt_temp) {
+    leituras_bme++;
+    if (alt_temp > 0.1f) {
+        altitude_bme = alt_temp;
+        janela_adicionar(&janela_baro, &alt_temp);
+    } else if (leituras_bme > 20 && janela_baro.contagem > 0) {
+        altitude_bme = janela_mediana(&janela_baro, 0);
+    }
+}
+
+// Aceleração para cima no referencial da Terra: projeção da leitura do
+// acelerômetro na direção da gravidade, menos 1 g
+static inline float aceleracao_vertical(const float aceleracao[3], const float gravidade[3]) {
+    return aceleracao[0] * gravidade[0] + aceleracao[1] * gravidade[1]
+         + aceleracao[2] * gravidade[2] - GRAVIDADE;
+}
+
+// Fusão e decimação de uma amostra da IMU adquirida em tempo_us. A cada
+// período da telemetria o decimador entrega atitude e acelerações filtradas.
+static void AERO_RAM_FUNC(imu_processar_amostra)(const mpu6500_amostra_t *amostra, float dt, uint64_t tempo_us) {
+    float entrada[CANAIS_DECIMADOR];
+    float saida[CANAIS_DECIMADOR];
+
+#ifdef AERO_AHRS
+    if (!ahrs_alinhado) {
+        ahrs_alinhar(&ahrs, amostra->aceleracao);
+        ahrs_alinhado = true;
+    }
+    uint32_t inicio = desempenho_ciclos();
+    ahrs_atualizar(&ahrs, amostra->aceleracao, amostra->giro, dt);
+    medidor_registrar(&medidor_fusao, inicio);
+    ahrs_gravidade(&ahrs, entrada);
+    entrada[3] = amostra->aceleracao[2];
+    float terra[3];
+    ahrs_para_terra(&ahrs, amostra->aceleracao, terra);
+    entrada[4] = terra[0];
+    entrada[5] = terra[1];
+    const float *gravidade = entrada;
+#else
+    uint32_t inicio = desempenho_ciclos();
+    mpu6500_fundir(amostra, &theta_fusao, &phi_fusao, dt);
+    medidor_registrar(&medidor_fusao, inicio);
+    entrada[0] = theta_fusao;
+    entrada[1] = phi_fusao;
+    entrada[2] = amostra->aceleracao[2];
+
+    // Direção da gravidade pelas definições de theta/phi do filtro
+    float gravidade[3] = { mat_sen_graus(theta_fusao), mat_sen_graus(phi_fusao), 0.0f };
+    float resto = 1.0f - gravidade[0] * gravidade[0] - gravidade[1] * gravidade[1];
+    gravidade[2] = resto > 0.0f ? mat_sqrt(resto) : 0.0f;
+#endif
+    vibracao_adicionar(amostra->aceleracao);
+
+    inicio = desempenho_ciclos();
+    kalman_vertical_propagar(&vertical, aceleracao_vertical(amostra->aceleracao, gravidade), dt);
+    medidor_registrar(&medidor_vertical, inicio);
+    tempo_ultima_imu = tempo_us;
+
+    inicio = desempenho_ciclos();
+    if (decimador_adicionar(&decimador_imu, entrada, saida)) {
+        float imu[NUM_VALORES_IMU];
+#ifdef AERO_AHRS
+        ahrs_angulos_graus(saida, &imu[IMU_THETA], &imu[IMU_PHI]);
+        imu[IMU_ACCEL_Z] = saida[3];
+        imu[IMU_ACEL_X_TERRA] = saida[4];
+        imu[IMU_ACEL_Y_TERRA] = saida[5];
+        imu[IMU_GUINADA] = ahrs_guinada_graus(&ahrs);
+#else
+        imu[IMU_THETA] = saida[0];
+        imu[IMU_PHI] = saida[1];
+        imu[IMU_ACCEL_Z] = saida[2];
+        imu[IMU_ACEL_X_TERRA] = imu[IMU_ACEL_Y_TERRA] = imu[IMU_GUINADA] = 0.0f;
+#endif
+        fluxo_publicar(&fluxo_imu, tempo_us - atraso_decimador_us, imu);
+    }
+    medidor_registrar(&medidor_decimador, inicio);
+}
+
+#ifdef AERO_IMU_FIFO
+// Lote da FIFO: as amostras têm espaçamento exato de 1/taxa
+static bool AERO_RAM_FUNC(imu_iniciar)(void) {
+    return mpu6500_iniciar_leitura_fifo() > 0;
+}
+
+static bool AERO_RAM_FUNC(imu_concluir)(void) {
+    static mpu6500_bruto_t lote[MPU6500_LOTE_MAX];
+    static mpu6500_amostra_t amostras[MPU6500_LOTE_MAX];
+    uint64_t tempo_us;
+    uint16_t n = mpu6500_concluir_leitura_fifo(lote, &tempo_us);
+    uint32_t periodo_us = 1000000u / mpu6500_taxa_fifo();
+    float dt = periodo_us / 1e6f;
+
+    // Com mais amostras na FIFO que o lote, a última lida não é a mais
+    // recente: o instante vem da âncora do pulso de dado pronto
+    mpu6500_converter_lote(lote, n, amostras, NULL);
+    for (int k = 0; k < n; k++) {
+        imu_processar_amostra(&amostras[k], dt, tempo_us + (uint64_t)k * periodo_us);
+    }
+    return n > 0;
+}
+#else
+// Uma amostra por ciclo, com dt medido entre ciclos
+static bool AERO_RAM_FUNC(imu_iniciar)(void) {
+    return mpu6500_iniciar_leitura_dma();
+}
+
+static bool AERO_RAM_FUNC(imu_concluir)(void) {
+    mpu6500_bruto_t bruto;
+    mpu6500_amostra_t amostra;
+    if (!mpu6500_concluir_leitura_dma(&bruto)) return false;
+
+    absolute_time_t t_atual = get_absolute_time();
+    float dt = absolute_time_diff_us(t_anterior, t_atual) / 1e6f;
+    t_anterior = t_atual;
+    mpu6500_converter_lote(&bruto, 1, &amostra, NULL);
+    imu_processar_amostra(&amostra, dt, to_us_since_boot(t_atual));
+    return true;
+}
+#endif
+
+// PRIORIDADE 1: Aquisição. A leitura do MPU6500 (i2c1) e, quando a conversão
+// do BME680 terminou, a leitura dos seus campos (i2c0) correm ao mesmo
+// tempo por DMA nos dois controladores.
+static void AERO_RAM_FUNC(tarefa_aquisicao)(void *contexto) {
+    uint32_t inicio = desempenho_ciclos();
+    bool imu_iniciada = imu_iniciar();
+    bool baro_iniciado = bme680_iniciar_coleta(&leitor_bme);
+
+    uint32_t inicio_etapa = desempenho_ciclos();
+    bool imu_concluida = imu_iniciada && imu_concluir();
+    if (imu_concluida) {
+        medidor_registrar(&medidor_imu, inicio_etapa);
+    }
+
+    inicio_etapa = desempenho_ciclos();
+    float alt_temp = 0;
+    if (baro_iniciado && bme680_concluir_coleta(&leitor_bme, pressao_base,
+                                                &pressao_atual, &alt_temp)) {
+        atualizar_altitude(alt_temp);
+        kalman_vertical_corrigir_baro(&vertical, alt_temp);
+        float baro[NUM_VALORES_BARO] = { [BARO_ALTITUDE] = altitude_bme, [BARO_PRESSAO] = pressao_atual };
+        fluxo_publicar(&fluxo_baro, leitor_bme.tempo_us, baro);
+        medidor_registrar(&medidor_baro, inicio_etapa);
+    }
+
+    // GGA a 1 Hz, publicado pela tarefa do GPS
+    static uint64_t gps_vertical_usado = 0;
+    amostra_tempo_t gps;
+    if (fluxo_mais_recente(&fluxo_gps, &gps) && gps.tempo_us != gps_vertical_usado) {
+        gps_vertical_usado = gps.tempo_us;
+        kalman_vertical_corrigir_gps(&vertical, gps.valores[GPS_Z]);
+    }
+
+    // O canal vertical foi propagado até a última amostra da IMU
+    if (imu_concluida) {
+        float estado[NUM_VALORES_VERT] = { [VERT_ALTITUDE] = vertical.x[0], [VERT_VELOCIDADE] = vertical.x[1] };
+        fluxo_publicar(&fluxo_vertical, tempo_ultima_imu, estado);
+    }
+    medidor_registrar(&medidor_aquisicao, inicio);
+}
+
+// Menor prioridade do núcleo da aquisição: FFT da janela já capturada
+static void tarefa_vibracao(void *contexto) {
+    uint32_t inicio = desempenho_ciclos();
+    if (vibracao_processar(&vibracao)) {
+        seqlock_publicar(&vibracao_lock, &vibracao_publicada, &vibracao, sizeof(vibracao));
+    }
+    medidor_registrar(&medidor_vibracao, inicio);
+}
+
+// PRIORIDADE 2: Processar as sentenças NMEA acumuladas pela IRQ da UART
+static void tarefa_gps(void *contexto) {
+    uint32_t inicio = desempenho_ciclos();
+    read_gps_data();
+
+    // Um fix completo por GGA (altitude nova), com o X/Y do último RMC,
+    // carimbado na chegada do '$' do GGA e não quando a tarefa o processa
+    // (até PERIODO_GPS_US depois). Resta o atraso fixo do receptor entre o
+    // segundo do fix e a emissão da sentença.
+    static uint32_t gps_publicado = 0;
+    uint32_t atualizacao = get_gps_altitude_updates();
+    if (atualizacao != gps_publicado && is_gps_valid()) {
+        gps_publicado = atualizacao;
+        float gps[NUM_VALORES_GPS] = {
+            [GPS_X] = (float)get_gps_x(), [GPS_Y] = (float)get_gps_y(), [GPS_Z] = (float)get_gps_z()
+        };
+        uint64_t tempo_gga_us = get_gps_altitude_time_us();
+        fluxo_publicar(&fluxo_gps, tempo_gga_us ? tempo_gga_us : time_us_64(), gps);
+    }
+    medidor_registrar(&medidor_gps, inicio);
+}
+
+// Estágio de alinhamento: o valor de cada fluxo no instante 'tempo_us'
+static void alinhar_fluxos(estado_alinhado_t *e, uint64_t tempo_us) {
+    fluxo_t *fluxos[NUM_IDADES] = { &fluxo_imu, &fluxo_baro, &fluxo_vertical, &fluxo_gps };
+    float *valores[NUM_IDADES] = { e->imu, e->baro, e->vertical, e->gps };
+    memset(e, 0, sizeof(*e));
+    for (int i = 0; i < NUM_IDADES; i++) {
+        if (!fluxo_alinhar(fluxos[i], tempo_us, valores[i], &e->idade_us[i])) {
+            e->idade_us[i] = UINT32_MAX;
+        }
+    }
+}
+
+// IDADE|tempo_us|imu_ms|baro_ms|vert_ms|gps_ms: tempo_us é o instante alinhado
+// da saída, as idades em ms (-1 = fluxo sem dados)
+static void enviar_idades(const estado_alinhado_t *e, uint64_t tempo_us) {
+    printf("IDADE|%llu", (unsigned long long)tempo_us);
+    for (int i = 0; i < NUM_IDADES; i++) {
+        if (e->idade_us[i] == UINT32_MAX) printf("|-1");
+        else printf("|%lu", (unsigned long)(e->idade_us[i] / 1000));
+    }
+    printf("\n");
+}
+
+// Saídas da telemetria com fix do GPS, a partir do estado alinhado em tempo_us
+static void enviar_saidas(const estado_alinhado_t *e, uint64_t tempo_us) {
+    // A GPS_neo_6 converte lat/lon em double; daqui em diante são metros locais em float
+    float zgps_raw = e->gps[GPS_Z];
+
+    // Iniciar captura apenas quando ZGPS > 0
+    if (zgps_raw > 0.0f) {
+        contador_captura++;
+        if (contador_captura == 1) {
+            printf("Iniciar captura\n");
+        }
+    }
+
+    // Hora do instante alinhado: relógio do Pico levado à hora do GPS pelo
+    // último RMC; sem referência ainda, a hora inteira do RMC
+    uint32_t tempo_ms;
+    if (!get_gps_time_ms(tempo_us, &tempo_ms)) tempo_ms = get_gps_time_seconds() * 1000;
+    uint32_t tempo_total = tempo_ms / 1000;
+
+    float xgps_raw = (float)get_gps_x();
+    float ygps_raw = (float)get_gps_y();
+
+    // X/Y: o fix novo reposiciona a navegação estimada; entre fixes ela
+    // avança um período da telemetria
+    static uint32_t fix_usado = 0;
+    uint32_t fix = get_gps_position_updates();
+    if (fix != fix_usado) {
+        fix_usado = fix;
+        nav_estimada_corrigir(&navegacao, xgps_raw, ygps_raw, (float)get_gps_velocity() / 3.6f,
+                              (float)get_gps_course(), e->imu[IMU_GUINADA]);
+    } else {
+        nav_estimada_propagar(&navegacao, &e->imu[IMU_ACEL_X_TERRA], PERIODO_TELEMETRIA_US / 1e6f);
+    }
+    float xgps = navegacao.posicao[0];
+    float ygps = navegacao.posicao[1];
+
+    // Z: filtro de média móvel
+    janela_adicionar(&janela_gps, &zgps_raw);
+    float zgps = janela_media(&janela_gps, 0);
+
+    // Atualizar dados HUD
+    hud_data.gps_time_ms = tempo_ms;
+    hud_data.tempo_us = tempo_us;
+    hud_data.latitude = xgps;
+    hud_data.longitude = ygps;
+    hud_data.altitude_gps = zgps;
+    hud_data.gps_sats = get_gps_satellites();
+    hud_data.altitude_bme = e->baro[BARO_ALTITUDE];
+    hud_data.altitude = e->vertical[VERT_ALTITUDE];
+    hud_data.vertical_speed = e->vertical[VERT_VELOCIDADE];
+    hud_data.velocity_cas = calcular_cas(e->baro[BARO_PRESSAO], pressao_base);
+    hud_data.accel_z = e->imu[IMU_ACCEL_Z];
+    hud_data.theta = e->imu[IMU_THETA];
+    hud_data.phi = e->imu[IMU_PHI];
+
+    // Tempo decorrido desde o início (em segundos)
+    hud_data.status = determinar_status(hud_data.altitude, hud_data.velocity_cas, tempo_total);
+
+    // SAÍDA 1: Dados para HUD (sobreposição vídeo)
+    enviar_hud(&hud_data);
+    enviar_idades(e, tempo_us);
+
+    // SAÍDA 2: Dados brutos (arquivo/análise)
+    salvar_dados_arquivo(xgps, ygps, zgps, hud_data.theta, hud_data.phi, tempo_ms, tempo_us);
+}
+
+static void tarefa_telemetria(void *contexto) {
+    uint32_t inicio = desempenho_ciclos();
+    estado_alinhado_t a;
+    uint64_t tempo_us = time_us_64() - atraso_alinhamento_us;  // Instante de todas as saídas
+    alinhar_fluxos(&a, tempo_us);
+
+    // Detecção de parada (altitude < 20cm)
+    if (a.baro[BARO_ALTITUDE] < 0.2f) {
+        printf("STOP\n");
+    }
+
+    // Processar GPS se válido; o ciclo entra no PERF|TLM com ou sem fix
+    if (is_gps_valid()) enviar_saidas(&a, tempo_us);
+    medidor_registrar(&medidor_telemetria, inicio);
+}
+
+static void tarefa_diagnostico(void *contexto) {
+#ifdef AERO_DUAL_CORE
+    agendador_imprimir_estatisticas(&agendador_aquisicao);
+#endif
+    agendador_imprimir_estatisticas(&agendador);
+    gps_print_stats();
+#ifdef AERO_GPS_PPS
+    gps_pps_print_stats();
+#endif
+#ifdef AERO_MPU6500_SPI
+    printf("SPI|MPU6500|%u|%u\n", mpu6500_spi_stats.transacoes, mpu6500_spi_stats.bytes);
+#else
+    i2c_dispositivo_imprimir_estatisticas(&mpu6500_i2c);
+#endif
+#ifdef AERO_BME680_SPI
+    printf("SPI|BME680|%u|%u\n", bme680_spi_stats.transacoes, bme680_spi_stats.bytes);
+#else
+    i2c_dispositivo_imprimir_estatisticas(&bme680_i2c);
+#endif
+    bme680_leitor_imprimir_estatisticas(&leitor_bme);
+    kalman_vertical_imprimir_estatisticas(&vertical);
+#ifdef AERO_IMU_FIFO
+    mpu6500_imprimir_estatisticas_fifo();
+#endif
+#ifdef AERO_AHRS
+    printf("AHRS|%lu\n", (unsigned long)ahrs.rejeicoes);  // Atualizações sem correção do acelerômetro
+#endif
+    medidor_imprimir(&medidor_aquisicao);
+    medidor_imprimir(&medidor_imu);
+    medidor_imprimir(&medidor_fusao);
+    medidor_imprimir(&medidor_decimador);
+    medidor_imprimir(&medidor_vertical);
+    medidor_imprimir(&medidor_baro);
+    medidor_imprimir(&medidor_gps);
+    medidor_imprimir(&medidor_telemetria);
+    medidor_imprimir(&medidor_vibracao);
+    desempenho_imprimir_xip();
+
+    vibracao_resultado_t v;
+    seqlock_ler(&vibracao_lock, &v, &vibracao_publicada, sizeof(v));
+    if (v.janelas > 0) vibracao_imprimir(&v);
+}
+
+#define TAREFA_AQ   { .nome = "AQ",   .periodo_us = PERIODO_AQUISICAO_US,   .prazo_us = 2000,  .funcao = tarefa_aquisicao }
+#define TAREFA_GPS  { .nome = "GPS",  .periodo_us = PERIODO_GPS_US,         .prazo_us = 5000,  .funcao = tarefa_gps }
+#define TAREFA_TLM  { .nome = "TLM",  .periodo_us = PERIODO_TELEMETRIA_US,  .prazo_us = 10000, .funcao = tarefa_telemetria }
+#define TAREFA_DIAG { .nome = "DIAG", .periodo_us = PERIODO_DIAGNOSTICO_US, .funcao = tarefa_diagnostico }
+#define TAREFA_VIB  { .nome = "VIB",  .periodo_us = PERIODO_VIBRACAO_US,    .funcao = tarefa_vibracao }
+
+// Ordem da tabela = prioridade
+#ifdef AERO_DUAL_CORE
+// core1: aquisição e filtragem; core0: NMEA e serialização USB
+static tarefa_t tarefas_aquisicao[] = { TAREFA_AQ, TAREFA_VIB };
+static tarefa_t tarefas[] = { TAREFA_GPS, TAREFA_TLM, TAREFA_DIAG };
+
+static void nucleo1_principal(void) {
+    desempenho_inicializar_nucleo();
+#ifdef AERO_CALIBRACAO_FLASH
+    flash_safe_execute_core_init();  // Para o core0 poder gravar o flash
+#endif
+    agendador_inicializar(&agendador_aquisicao, tarefas_aquisicao, count_of(tarefas_aquisicao));
+    agendador_executar(&agendador_aquisicao);
+}
+#else
+static tarefa_t tarefas[] = { TAREFA_AQ, TAREFA_GPS, TAREFA_TLM, TAREFA_DIAG, TAREFA_VIB };
+#endif
+
+// Biases da IMU e pressão base. Com AERO_CALIBRACAO_FLASH, o registro do
+// flash é usado quando passa na verificação rápida (~0,5 s); a pressão
+// base vem sempre de uma medida nova, porque é o zero da altitude no solo
+// de agora. A calibração completa (~11 s) é gravada para o próximo boot.
+static bool calibrar_sensores(void) {
+#ifdef AERO_CALIBRACAO_FLASH
+    calibracao_t calibracao;
+    bool valida = false;
+    if (calibracao_pedida()) {
+        printf("Recalibração pedida (GPIO %d)\n", PINO_RECALIBRAR);
+    } else if (!calibracao_carregar(&calibracao)) {
+        printf("Sem calibração válida no flash\n");
+    } else {
+        valida = true;
+    }
+
+    float pressao, temperatura;
+    bool medida = bme680_medir(&sensor, periodo_bme, NUM_VERIFICACAO_BARO, &pressao, &temperatura);
+    if (valida && (!medida ||
+                   fabsf(temperatura - calibracao.temperatura) > CALIBRACAO_LIMITE_TEMPERATURA_C)) {
+        printf("Calibração do flash fora dos limites: %.1f °C (gravada a %.1f °C)\n",
+               (double)temperatura, (double)calibracao.temperatura);
+        valida = false;
+    }
+    if (valida) {
+        memcpy(bias_giro, calibracao.bias_giro, sizeof(bias_giro));
+        memcpy(erro_aceleracao, calibracao.erro_aceleracao, sizeof(erro_aceleracao));
+        mpu6500_atualizar_offsets();
+        valida = mpu6500_verificar_calibracao();
+    }
+    if (valida) {
+        pressao_base = pressao;
+        printf("Calibração do flash aplicada (gravada a %.1f °C)\n", (double)calibracao.temperatura);
+        return true;
+    }
+#endif
+
+    pressao_base = calibrar_pressao(&sensor, periodo_bme);
+    printf("Calibrando giroscópio...\n");
+    calibra_giroscopio();
+    printf("Calibrando acelerômetro...\n");
+    calibra_aceleracao();
+    if (pressao_base <= 0.0f) return false;
+
+#ifdef AERO_CALIBRACAO_FLASH
+    if (medida) {
+        memcpy(calibracao.bias_giro, bias_giro, sizeof(bias_giro));
+        memcpy(calibracao.erro_aceleracao, erro_aceleracao, sizeof(erro_aceleracao));
+        calibracao.temperatura = temperatura;
+        if (calibracao_gravar(&calibracao)) printf("Calibração gravada no flash\n");
+    }
+#endif
+    return true;
 }
 
 int main() {
     stdio_init_all();
-    sleep_ms(2000);
+    desempenho_inicializar_nucleo();
+    // Tempo para o terminal USB abrir a porta e ver o boot
+    for (int i = 0; i < 200 && !stdio_usb_connected(); i++) sleep_ms(10);
     printf("Sistema iniciando...\n");
 
     // GPS
     printf("Inicializando GPS...\n");
     gps_init();
+#ifdef AERO_GPS_PPS
+    gps_pps_init();
+#endif
     sleep_ms(200);
     printf("GPS inicializado\n");
 
     // BME680
     printf("Inicializando BME680...\n");
-    struct bme680_dev sensor;
-    uint16_t periodo_bme;
     bme680_inicializar(&sensor, &periodo_bme);
-    float pressao_base = calibrar_pressao(&sensor, periodo_bme);
-    printf("BME680 pronto - Pressão base: %.2f hPa\n", pressao_base);
 
     // MPU6500
     printf("Inicializando MPU6500...\n");
-    i2c_init(I2C_PORT, 400 * 1000);
-    gpio_set_function(SDA_PIN, GPIO_FUNC_I2C);
-    gpio_set_function(SCL_PIN, GPIO_FUNC_I2C);
-    gpio_pull_up(SDA_PIN);
-    gpio_pull_up(SCL_PIN);
-
     mpu6500_inicializar();
     
-    uint8_t id, buf;
-    i2c_write_blocking(I2C_PORT, MPU6500_ENDERECO, (uint8_t[]){0x75}, 1, true);
-    i2c_read_blocking(I2C_PORT, MPU6500_ENDERECO, &buf, 1, false);
-    id = buf;
+    uint8_t id = mpu6500_ler_id();
     
     if (id != 0x70 && id != 0x68) {
         printf("ERRO: MPU6500 não detectado (ID: 0x%02X)\n", id);
@@ -199,123 +718,67 @@ int main() {
     }
     printf("MPU6500 detectado (ID: 0x%02X)\n", id);
 
-    printf("Calibrando giroscópio...\n");
-    calibra_giroscopio();
-    printf("Calibrando acelerômetro...\n");
-    calibra_aceleracao();
+    if (!calibrar_sensores()) {
+        printf("ERRO: calibração da pressão base falhou\n");
+    }
+#ifdef AERO_BME680_BENCHMARK
+    bme680_benchmark_perfis(&sensor, pressao_base);
+#endif
+    bme680_leitor_inicializar(&leitor_bme, &sensor, periodo_bme);
+    printf("BME680 pronto - Pressão base: %.2f hPa\n", (double)pressao_base);
+
+#ifdef AERO_IMU_FIFO
+    mpu6500_configurar_fifo(MPU6500_TAXA_FIFO_HZ);
+    printf("MPU6500 em modo FIFO a %u Hz\n", MPU6500_TAXA_FIFO_HZ);
+#endif
 
-    float theta = 0.0, phi = 0.0;
-    float accel_x = 0, accel_y = 0, accel_z = 0;
-    absolute_time_t t_anterior = get_absolute_time();
+#ifdef AERO_IMU_FIFO
+    uint32_t taxa_imu = mpu6500_taxa_fifo();
+#else
+    uint32_t taxa_imu = 1000000 / PERIODO_AQUISICAO_US;
+#endif
+    uint16_t taps = DECIMADOR_TAPS ? DECIMADOR_TAPS : decimador_taps_minimos(taxa_imu, TAXA_TELEMETRIA_HZ);
+    if (!decimador_inicializar(&decimador_imu, CANAIS_DECIMADOR, taps,
+                               taxa_imu, TAXA_TELEMETRIA_HZ)) {
+        printf("ERRO: decimador de %u taps não suporta %lu -> %u Hz\n",
+               taps, (unsigned long)taxa_imu, TAXA_TELEMETRIA_HZ);
+        return 1;
+    }
+    vibracao_inicializar(taxa_imu);
+    kalman_vertical_inicializar(&vertical);
+    atraso_decimador_us = (taps - 1) * 500000u / taxa_imu;
+    atraso_alinhamento_us = atraso_decimador_us + PERIODO_TELEMETRIA_US + PERIODO_AQUISICAO_US;
+    // O fluxo mais rápido (VERT, a cada aquisição) precisa ainda guardar uma
+    // amostra anterior ao instante lido, com um período de folga
+    if ((FLUXO_PROFUNDIDADE - 2) * PERIODO_AQUISICAO_US < atraso_alinhamento_us) {
+        printf("ERRO: FLUXO_PROFUNDIDADE %u não cobre o atraso de alinhamento de %lu us\n",
+               FLUXO_PROFUNDIDADE, (unsigned long)atraso_alinhamento_us);
+        return 1;
+    }
+    nav_estimada_inicializar(&navegacao);
+    janela_inicializar(&janela_gps, 1, GPS_FILTER_SIZE);
+    janela_inicializar(&janela_baro, 1, BARO_JANELA);
+#ifdef AERO_AHRS
+    ahrs_inicializar(&ahrs, AHRS_KP_PADRAO, AHRS_KI_PADRAO);
+    printf("AHRS Mahony: Kp %.2f Ki %.3f\n", (double)ahrs.kp, (double)ahrs.ki);
+#endif
+    printf("Decimador FIR: %u taps, %lu -> %u Hz, alinhamento em %lu ms\n", taps,
+           (unsigned long)taxa_imu, TAXA_TELEMETRIA_HZ, (unsigned long)(atraso_alinhamento_us / 1000));
+
+#ifdef AERO_MATEMATICA_BENCHMARK
+    matematica_rapida_benchmark();
+    mpu6500_benchmark_lote();
+#endif
 
     printf("\n=== SISTEMA PRONTO ===\n");
     printf("Aguardando fix GPS...\n\n");
 
-    uint32_t contador = 0;
-    uint32_t contador_captura = 0;  // Contador de capturas GPS válidas
-    float altitude_bme = 0.0;
-    float altitude_bme_anterior = 0.0;
-    float pressao_atual = 0.0;
-    
-    // Variáveis para tempo contínuo
-    uint32_t gps_time_offset = 0;
-    absolute_time_t tempo_inicio = {0};
-    bool tempo_inicializado = false;
-
-    while (true) {
-        contador++;
-        absolute_time_t t_atual = get_absolute_time();
-        float dt = absolute_time_diff_us(t_anterior, t_atual) / 1e6f;
-        t_anterior = t_atual;
-        
-        // PRIORIDADE 1: Leitura MPU6500
-        leitura(bias_giro, erro_aceleracao, &theta, &phi, dt);
-        
-        // TODO: Ler aceleração bruta do MPU6500 para fator de carga
-        // Por enquanto usar theta/phi como proxy
-        accel_z = cos(phi * 3.14159 / 180.0) * G_ACCEL;
-        
-        // PRIORIDADE 2: Leitura GPS múltiplas vezes
-        for (int i = 0; i < 10; i++) {
-            read_gps_data();
-        }
-        
-        // PRIORIDADE 3: Leitura BME680
-        if (contador % 5 == 0) {
-            float alt_temp = 0;
-            bme680_ler_altitude(&sensor, periodo_bme, pressao_base, 
-                               &pressao_atual, &alt_temp);
-            
-            // Proteção: guardar último valor válido
-            if (alt_temp > 0.1f) {
-                altitude_bme = alt_temp;
-                altitude_bme_anterior = alt_temp;
-            } else if (contador > 100) {
-                altitude_bme = altitude_bme_anterior;
-            }
-        }
-        
-        // Detecção de parada (altitude < 20cm)
-        if (altitude_bme < 0.2f) {
-            printf("STOP\n");
-        }
-
-        // Processar GPS se válido
-        if (is_gps_valid()) {
-            double zgps_raw = get_gps_z();
-            
-            // Iniciar captura apenas quando ZGPS > 0
-            if (zgps_raw > 0) {
-                contador_captura++;
-                if (contador_captura == 1) {
-                    printf("Iniciar captura\n");
-                }
-            }
-            
-            // Inicializar tempo na primeira leitura válida
-            if (!tempo_inicializado) {
-                gps_time_offset = get_gps_time_seconds();
-                tempo_inicio = get_absolute_time();
-                tempo_inicializado = true;
-            }
-            
-            // Calcular tempo contínuo: tempo_gps_inicial + segundos decorridos no Pico
-            uint32_t tempo_pico_ms = absolute_time_diff_us(tempo_inicio, t_atual) / 1000;
-            uint32_t tempo_total = gps_time_offset + (tempo_pico_ms / 1000);
-            
-            double xgps_raw = get_gps_x();
-            double ygps_raw = get_gps_y();
-            // zgps_raw já foi declarado acima, não redeclarar
-            
-            // Filtro de média móvel
-            gps_filter_add(xgps_raw, ygps_raw, zgps_raw);
-            double xgps = 0, ygps = 0, zgps = 0;
-            gps_filter_get_average(&xgps, &ygps, &zgps);
-            
-            // Atualizar dados HUD
-            hud_data.gps_time = tempo_total;
-            hud_data.latitude = xgps;
-            hud_data.longitude = ygps;
-            hud_data.altitude_gps = zgps;
-            hud_data.gps_sats = get_gps_satellites();
-            hud_data.altitude_bme = altitude_bme;
-            hud_data.velocity_cas = calcular_cas(pressao_atual, pressao_base);
-            hud_data.accel_z = accel_z;
-            hud_data.theta = theta;
-            hud_data.phi = phi;
-            
-            // Tempo decorrido desde o início (em segundos)
-            hud_data.status = determinar_status(altitude_bme, hud_data.velocity_cas, tempo_total);
-            
-            // SAÍDA 1: Dados para HUD (sobreposição vídeo)
-            enviar_hud(&hud_data);
-            
-            // SAÍDA 2: Dados brutos (arquivo/análise)
-            salvar_dados_arquivo(xgps, ygps, zgps, theta, phi, tempo_total);
-        }
-        
-        sleep_ms(20);
-    }
+    t_anterior = get_absolute_time();
+#ifdef AERO_DUAL_CORE
+    multicore_launch_core1(nucleo1_principal);
+#endif
+    agendador_inicializar(&agendador, tarefas, count_of(tarefas));
+    agendador_executar(&agendador);
 
     return 0;
 }
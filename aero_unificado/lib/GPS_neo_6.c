@@ -3,11 +3,32 @@
  */
 
 #include "GPS_neo_6.h"
+#include "desempenho.h"
+#include "relogio_pps.h"
 
 #define GPS_UART_ID uart0
 #define GPS_BAUD_RATE 9600
 #define GPS_TX_PIN 17
 #define GPS_RX_PIN 16
+#define GPS_PPS_PIN 15  // Timepulse do NEO-6 (borda de subida no início do segundo UTC)
+
+// Buffer circular preenchido pela IRQ de RX da UART (~1 s de dados a 9600 baud)
+#define GPS_RX_BUFFER_SIZE 1024  // Potência de 2
+static volatile char rx_buffer[GPS_RX_BUFFER_SIZE];
+static volatile uint32_t rx_head = 0;  // Escrito apenas pela IRQ
+static volatile uint32_t rx_tail = 0;  // Escrito apenas pelo consumidor
+static volatile uint32_t rx_overflows = 0;        // Bytes descartados com o buffer cheio
+static volatile uint32_t rx_overruns_uart = 0;    // Estouros da FIFO de hardware
+
+// Instante de chegada de cada '$' (posição no buffer + time_us_64 na IRQ):
+// a hora UTC do RMC fica amarrada ao relógio do Pico no início da sentença,
+// não ao momento em que a tarefa do GPS a processa
+#define GPS_MARCAS 32  // Potência de 2; > sentenças que cabem no buffer
+static volatile uint32_t marca_posicao[GPS_MARCAS];
+static volatile uint64_t marca_us[GPS_MARCAS];
+static volatile uint32_t marca_head = 0;  // Escrito apenas pela IRQ
+static volatile uint32_t marca_tail = 0;  // Escrito apenas pelo consumidor
+static uint64_t inicio_sentenca_us = 0;   // Chegada do '$' da sentença em montagem
 
 #define NMEA_BUFFER_SIZE 256
 static char nmea_buffer[NMEA_BUFFER_SIZE];
@@ -30,8 +51,25 @@ static uint32_t sentences_gpgga = 0;
 #define POSITION_THRESHOLD 0.5
 
 static double zgps_anterior = 0.0;  // Guardar último ZGPS válido
-
-static void latlon_to_xy(double latitude, double longitude, double lat0, double lon0, double* XGPS, double* YGPS) {
+static uint32_t altitude_updates = 0;  // Altitudes novas do GGA (com fix)
+static uint64_t altitude_tempo_us = 0;  // Chegada do '$' do GGA da última altitude
+static uint32_t position_updates = 0;  // Fixes novos do RMC
+
+// Referência de hora: UTC do último RMC válido e o instante do Pico em que
+// a sentença começou a chegar. O receptor emite o RMC algumas dezenas de ms
+// depois do segundo que ele carimba; esse atraso fixo fica na referência.
+// Com o PPS travado, a hora sai do relógio disciplinado.
+#define MS_POR_DIA 86400000u
+#define FUSO_BRASILIA_MS (3u * 3600000u)
+static uint32_t utc_ref_ms = 0;
+static uint64_t utc_ref_us = 0;  // 0 = sem referência
+
+static volatile uint64_t pps_ultimo_us = 0;  // Escritos apenas pela IRQ do PPS
+static volatile uint32_t pps_bordas = 0;
+static uint32_t pps_bordas_usadas = 0;
+static relogio_pps_t relogio_pps;
+
+static void AERO_RAM_FUNC(latlon_to_xy)(double latitude, double longitude, double lat0, double lon0, double* XGPS, double* YGPS) {
     double dLat = (latitude - lat0) * DEG_TO_RAD;
     double dLon = (longitude - lon0) * DEG_TO_RAD;
     double latRad = lat0 * DEG_TO_RAD;
@@ -39,7 +77,7 @@ static void latlon_to_xy(double latitude, double longitude, double lat0, double
     *YGPS = dLat * EARTH_RADIUS;
 }
 
-static void convert_utc_to_brasilia(const char* utc_time, char* br_time, uint32_t* seconds) {
+static void AERO_RAM_FUNC(convert_utc_to_brasilia)(const char* utc_time, char* br_time, uint32_t* seconds) {
     if (strlen(utc_time) < 6) {
         strcpy(br_time, "00:00:00");
         *seconds = 0;
@@ -54,13 +92,28 @@ static void convert_utc_to_brasilia(const char* utc_time, char* br_time, uint32_
     *seconds = (uint32_t)(hours * 3600 + minutes * 60 + seconds_part);
 }
 
-static uint8_t calculate_nmea_checksum(const char* sentence, int start, int end) {
+// hhmmss[.sss] -> ms desde 0h UTC
+static uint32_t AERO_RAM_FUNC(parse_utc_ms)(const char* utc_time) {
+    uint32_t hours = (utc_time[0] - '0') * 10 + (utc_time[1] - '0');
+    uint32_t minutes = (utc_time[2] - '0') * 10 + (utc_time[3] - '0');
+    uint32_t seconds_part = (utc_time[4] - '0') * 10 + (utc_time[5] - '0');
+    uint32_t ms = 0;
+    if (utc_time[6] == '.') {
+        uint32_t peso = 100;
+        for (const char *p = &utc_time[7]; *p >= '0' && *p <= '9' && peso > 0; p++, peso /= 10) {
+            ms += (uint32_t)(*p - '0') * peso;
+        }
+    }
+    return ((hours * 60 + minutes) * 60 + seconds_part) * 1000 + ms;
+}
+
+static uint8_t AERO_RAM_FUNC(calculate_nmea_checksum)(const char* sentence, int start, int end) {
     uint8_t checksum = 0;
     for (int i = start; i < end; i++) checksum ^= (uint8_t)sentence[i];
     return checksum;
 }
 
-static bool validate_nmea_checksum(const char* sentence) {
+static bool AERO_RAM_FUNC(validate_nmea_checksum)(const char* sentence) {
     int len = strlen(sentence);
     if (len < 5) return false;
     int star_pos = -1;
@@ -75,7 +128,7 @@ static bool validate_nmea_checksum(const char* sentence) {
     return calculated == received;
 }
 
-static double nmea_to_decimal(const char* coord, char direction) {
+static double AERO_RAM_FUNC(nmea_to_decimal)(const char* coord, char direction) {
     if (coord == NULL || strlen(coord) == 0) return 0.0;
     double value = atof(coord);
     int degrees = (int)(value / 100.0);
@@ -85,13 +138,46 @@ static double nmea_to_decimal(const char* coord, char direction) {
     return decimal;
 }
 
-static void process_gprmc(const char* sentence) {
+// O pulso mais recente antes do RMC marca o segundo UTC que ele carimba;
+// cada borda é casada uma vez só (RMC a mais de 1 Hz)
+static void casar_pulso_pps(uint32_t segundo_utc) {
+    uint32_t bordas;
+    uint64_t pulso_us;
+    do {
+        bordas = pps_bordas;
+        pulso_us = pps_ultimo_us;
+    } while (bordas != pps_bordas);
+
+    if (bordas == pps_bordas_usadas) return;
+    if (pulso_us > inicio_sentenca_us || inicio_sentenca_us - pulso_us >= 1000000) return;
+    pps_bordas_usadas = bordas;
+    relogio_pps_pulso(&relogio_pps, pulso_us, segundo_utc);
+}
+
+// Separa os campos da sentença em 'copia' (vírgulas e '*' viram '\0').
+// Campos vazios contam (o strtok os pularia e deslocaria os seguintes);
+// retorna o número de campos, até 'maximo'
+static int AERO_RAM_FUNC(separar_campos)(char *copia, char **campos, int maximo) {
+    char *asterisco = strchr(copia, '*');
+    if (asterisco) *asterisco = '\0';
+    int n = 0;
+    char *campo = copia;
+    while (campo != NULL && n < maximo) {
+        campos[n++] = campo;
+        char *virgula = strchr(campo, ',');
+        if (virgula) *virgula++ = '\0';
+        campo = virgula;
+    }
+    return n;
+}
+
+static void AERO_RAM_FUNC(process_gprmc)(const char* sentence) {
     sentences_gprmc++;
     
     char temp_sentence[NMEA_BUFFER_SIZE];
     strcpy(temp_sentence, sentence);
-    char* token = strtok(temp_sentence, ",");
-    int field = 0;
+    char *campos[9];
+    int num_campos = separar_campos(temp_sentence, campos, 9);
 
     char time_str[12] = {0};
     char status = 'V';
@@ -100,8 +186,10 @@ static void process_gprmc(const char* sentence) {
     char lon_str[16] = {0};
     char lon_dir = 0;
     char speed_str[16] = {0};
+    char course_str[16] = {0};
 
-    while (token != NULL) {
+    for (int field = 0; field < num_campos; field++) {
+        const char *token = campos[field];
         switch (field) {
             case 1:
                 if (strlen(token) >= 6) strncpy(time_str, token, 11);
@@ -124,9 +212,10 @@ static void process_gprmc(const char* sentence) {
             case 7:
                 if (strlen(token) > 0) strncpy(speed_str, token, 15);
                 break;
+            case 8:
+                if (strlen(token) > 0) strncpy(course_str, token, 15);
+                break;
         }
-        token = strtok(NULL, ",");
-        field++;
     }
 
     if (strlen(time_str) >= 6) {
@@ -137,12 +226,20 @@ static void process_gprmc(const char* sentence) {
 
     if (status == 'A') {
         gps_data.valid_fix = true;
+
+        if (strlen(time_str) >= 6 && inicio_sentenca_us != 0) {
+            utc_ref_ms = parse_utc_ms(time_str);
+            utc_ref_us = inicio_sentenca_us;
+            casar_pulso_pps(utc_ref_ms / 1000);
+        }
         
         if (strlen(speed_str) > 0) {
             double speed_knots = atof(speed_str);
             gps_data.velocity = speed_knots * 1.852;
             if (gps_data.velocity < 0.5) gps_data.velocity = 0.0;
         }
+        // Vazio com o receptor parado: mantém o último rumo
+        if (strlen(course_str) > 0) gps_data.course = atof(course_str);
         
         if (strlen(lat_str) > 0 && strlen(lon_str) > 0) {
             gps_data.latitude = nmea_to_decimal(lat_str, lat_dir);
@@ -167,23 +264,25 @@ static void process_gprmc(const char* sentence) {
                     gps_data.YGPS = new_y;
                 }
             }
+            position_updates++;
         }
     } else {
         gps_data.valid_fix = false;
     }
 }
 
-static void process_gpgga(const char* sentence) {
+static void AERO_RAM_FUNC(process_gpgga)(const char* sentence) {
     char temp_sentence[NMEA_BUFFER_SIZE];
     strcpy(temp_sentence, sentence);
-    char* token = strtok(temp_sentence, ",");
-    int field = 0;
+    char *campos[10];
+    int num_campos = separar_campos(temp_sentence, campos, 10);
 
     char fix_quality = '0';
     char alt_str[16] = {0};
     char num_sat_str[8] = {0};
 
-    while (token != NULL) {
+    for (int field = 0; field < num_campos; field++) {
+        const char *token = campos[field];
         switch (field) {
             case 6: // Fix quality
                 if (strlen(token) > 0) fix_quality = token[0];
@@ -206,6 +305,8 @@ static void process_gpgga(const char* sentence) {
                     if (zgps_novo > 0) {
                         gps_data.ZGPS = zgps_novo;
                         zgps_anterior = zgps_novo;  // Guardar como válido
+                        altitude_updates++;
+                        altitude_tempo_us = inicio_sentenca_us;
                     } else {
                         // Se receber 0 ou negativo, mantém o anterior
                         gps_data.ZGPS = zgps_anterior;
@@ -216,11 +317,9 @@ static void process_gpgga(const char* sentence) {
                 }
                 break;
         }
-        token = strtok(NULL, ",");
-        field++;
     }
 }
-static void process_nmea_sentence(const char* sentence) {
+static void AERO_RAM_FUNC(process_nmea_sentence)(const char* sentence) {
     sentences_received++;
     
     if (!validate_nmea_checksum(sentence)) return;
@@ -234,17 +333,102 @@ static void process_nmea_sentence(const char* sentence) {
     }
 }
 
+static void AERO_RAM_FUNC(gps_uart_irq)(void) {
+    uart_hw_t *hw = uart_get_hw(GPS_UART_ID);
+    if (hw->rsr & UART_UARTRSR_OE_BITS) {
+        rx_overruns_uart++;
+        hw->rsr = UART_UARTRSR_OE_BITS;
+    }
+
+    while (uart_is_readable(GPS_UART_ID)) {
+        char c = uart_getc(GPS_UART_ID);
+        uint32_t proximo = (rx_head + 1) & (GPS_RX_BUFFER_SIZE - 1);
+        if (proximo == rx_tail) {
+            // Buffer cheio: o byte é descartado e a sentença falha no checksum
+            rx_overflows++;
+            continue;
+        }
+        if (c == '$') {
+            uint32_t marca = marca_head;
+            uint32_t proxima_marca = (marca + 1) & (GPS_MARCAS - 1);
+            if (proxima_marca != marca_tail) {
+                marca_posicao[marca] = rx_head;
+                marca_us[marca] = time_us_64();
+                marca_head = proxima_marca;
+            }
+        }
+        rx_buffer[rx_head] = c;
+        rx_head = proximo;
+    }
+}
+
+// Instante de chegada do '$' lido da posição dada; marcas de '$' já
+// consumidas por outro leitor são descartadas. 0 se a marca se perdeu.
+static uint64_t AERO_RAM_FUNC(gps_rx_marca)(uint32_t posicao) {
+    // Cabeça das marcas antes da do buffer: a IRQ grava a marca antes do byte
+    uint32_t head = marca_head;
+    uint32_t pendentes = (rx_head - posicao) & (GPS_RX_BUFFER_SIZE - 1);
+    while (marca_tail != head) {
+        uint32_t marca = marca_tail;
+        uint32_t distancia = (marca_posicao[marca] - posicao) & (GPS_RX_BUFFER_SIZE - 1);
+        if (distancia == 0) {
+            uint64_t us = marca_us[marca];
+            marca_tail = (marca + 1) & (GPS_MARCAS - 1);
+            return us;
+        }
+        if (distancia <= pendentes) return 0;  // Marca de um '$' ainda não lido
+        marca_tail = (marca + 1) & (GPS_MARCAS - 1);
+    }
+    return 0;
+}
+
+static bool AERO_RAM_FUNC(gps_rx_getc)(char *c) {
+    uint32_t tail = rx_tail;
+    if (tail == rx_head) return false;
+    *c = rx_buffer[tail];
+    rx_tail = (tail + 1) & (GPS_RX_BUFFER_SIZE - 1);
+    return true;
+}
+
+static void AERO_RAM_FUNC(gps_pps_irq)(void) {
+    if (gpio_get_irq_event_mask(GPS_PPS_PIN) & GPIO_IRQ_EDGE_RISE) {
+        gpio_acknowledge_irq(GPS_PPS_PIN, GPIO_IRQ_EDGE_RISE);
+        pps_ultimo_us = time_us_64();
+        pps_bordas++;
+    }
+}
+
 void gps_init(void) {
+    relogio_pps_inicializar(&relogio_pps);
+
     uart_init(GPS_UART_ID, GPS_BAUD_RATE);
     gpio_set_function(GPS_TX_PIN, GPIO_FUNC_UART);
     gpio_set_function(GPS_RX_PIN, GPIO_FUNC_UART);
     uart_set_format(GPS_UART_ID, 8, 1, UART_PARITY_NONE);
     uart_set_fifo_enabled(GPS_UART_ID, true);
+
+    // RX por interrupção (dispara com a FIFO meio cheia ou por timeout de recepção)
+    int uart_irq = UART_IRQ_NUM(GPS_UART_ID);
+    irq_set_exclusive_handler(uart_irq, gps_uart_irq);
+    irq_set_enabled(uart_irq, true);
+    uart_set_irq_enables(GPS_UART_ID, true, false);
 }
 
-void read_gps_data(void) {
-    while (uart_is_readable(GPS_UART_ID)) {
-        char c = uart_getc(GPS_UART_ID);
+void gps_pps_init(void) {
+    gpio_init(GPS_PPS_PIN);
+    gpio_set_dir(GPS_PPS_PIN, GPIO_IN);
+    gpio_pull_down(GPS_PPS_PIN);
+    gpio_add_raw_irq_handler(GPS_PPS_PIN, gps_pps_irq);
+    gpio_set_irq_enabled(GPS_PPS_PIN, GPIO_IRQ_EDGE_RISE, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+}
+
+// Consome o buffer circular; só sentenças completas (terminadas em CR/LF ou
+// pelo próximo '$') são processadas, o resto fica para a próxima chamada
+void AERO_RAM_FUNC(read_gps_data)(void) {
+    char c;
+    uint32_t posicao = rx_tail;
+    while (gps_rx_getc(&c)) {
         
         if (c == '$') {
             // Se havia dados antes, processa antes de resetar
@@ -254,6 +438,7 @@ void read_gps_data(void) {
                     process_nmea_sentence(nmea_buffer);
                 }
             }
+            inicio_sentenca_us = gps_rx_marca(posicao);
             buffer_index = 0;
             nmea_buffer[buffer_index++] = c;
         } 
@@ -269,14 +454,15 @@ void read_gps_data(void) {
         else if (buffer_index < NMEA_BUFFER_SIZE - 1) {
             nmea_buffer[buffer_index++] = c;
         }
+        posicao = rx_tail;
     }
 }
 
 // Adicione esta função ao GPS_neo_6.c para DEBUG apenas do ZGPS
 
 void read_gps_data_zgps_debug(void) {
-    while (uart_is_readable(GPS_UART_ID)) {
-        char c = uart_getc(GPS_UART_ID);
+    char c;
+    while (gps_rx_getc(&c)) {
         
         if (c == '$') {
             if (buffer_index > 0) {
@@ -320,8 +506,8 @@ void read_gps_data_zgps_debug(void) {
     }
 }
 void read_gps_data_debug(void) {
-    while (uart_is_readable(GPS_UART_ID)) {
-        char c = uart_getc(GPS_UART_ID);
+    char c;
+    while (gps_rx_getc(&c)) {
         if (c == '$') {
             buffer_index = 0;
             nmea_buffer[buffer_index++] = c;
@@ -357,8 +543,8 @@ void test_uart_raw(void) {
     uint32_t byte_count = 0;
     
     while (absolute_time_diff_us(start, get_absolute_time()) < 10000000) {  // 10 segundos
-        if (uart_is_readable(GPS_UART_ID)) {
-            char c = uart_getc(GPS_UART_ID);
+        char c;
+        while (gps_rx_getc(&c)) {
             printf("%c", c);
             byte_count++;
         }
@@ -404,6 +590,35 @@ uint32_t get_gps_time_seconds(void) {
     return gps_data.time_seconds;
 }
 
+bool get_gps_utc_us(uint64_t time_us, uint64_t *utc_us) {
+    if (relogio_pps_utc_us(&relogio_pps, time_us, utc_us)) return true;
+    if (utc_ref_us == 0) return false;
+    // Antes da referência (amostra alinhada atrás do último RMC) conta para trás
+    const int64_t us_por_dia = (int64_t)MS_POR_DIA * 1000;
+    int64_t us = ((int64_t)utc_ref_ms * 1000 + ((int64_t)time_us - (int64_t)utc_ref_us)) % us_por_dia;
+    if (us < 0) us += us_por_dia;
+    *utc_us = (uint64_t)us;
+    return true;
+}
+
+bool get_gps_utc_ms(uint64_t time_us, uint32_t *utc_ms) {
+    uint64_t utc_us;
+    if (!get_gps_utc_us(time_us, &utc_us)) return false;
+    *utc_ms = (uint32_t)(utc_us / 1000);
+    return true;
+}
+
+bool is_gps_pps_locked(void) {
+    return relogio_pps.travado;
+}
+
+bool get_gps_time_ms(uint64_t time_us, uint32_t *br_ms) {
+    uint32_t utc_ms;
+    if (!get_gps_utc_ms(time_us, &utc_ms)) return false;
+    *br_ms = (utc_ms + MS_POR_DIA - FUSO_BRASILIA_MS) % MS_POR_DIA;
+    return true;
+}
+
 double get_gps_x(void) {
     return gps_data.XGPS;
 }
@@ -416,6 +631,22 @@ double get_gps_z(void) {
     return gps_data.ZGPS;
 }
 
+double get_gps_course(void) {
+    return gps_data.course;
+}
+
+uint32_t get_gps_position_updates(void) {
+    return position_updates;
+}
+
+uint32_t get_gps_altitude_updates(void) {
+    return altitude_updates;
+}
+
+uint64_t get_gps_altitude_time_us(void) {
+    return altitude_tempo_us;
+}
+
 double get_gps_velocity(void) {
     return gps_data.velocity;
 }
@@ -424,9 +655,17 @@ int get_gps_satellites(void) {
     return atoi(gps_data.satellites);
 }
 
+void gps_pps_print_stats(void) {
+    relogio_pps_imprimir_estatisticas(&relogio_pps);
+}
+
+uint32_t get_gps_overflow_count(void) {
+    return rx_overflows + rx_overruns_uart;
+}
+
 // Função de diagnóstico
 void gps_print_stats(void) {
-    printf("[STATS] Total=%u Validas=%u RMC=%u GGA=%u Fix=%d Sats=%s\n",
+    printf("[STATS] Total=%u Validas=%u RMC=%u GGA=%u Fix=%d Sats=%s Overflow=%u Overrun=%u\n",
            sentences_received, sentences_valid, sentences_gprmc, sentences_gpgga,
-           gps_data.valid_fix, gps_data.satellites);
+           gps_data.valid_fix, gps_data.satellites, rx_overflows, rx_overruns_uart);
 }
\ No newline at end of file
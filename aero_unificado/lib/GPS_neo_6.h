@@ -13,6 +13,7 @@
 #include <math.h>
 #include "pico/stdlib.h"
 #include "hardware/uart.h"
+#include "hardware/irq.h"
 #include "pico/time.h"
 
 // Estrutura de dados GPS (apenas para uso interno)
@@ -26,6 +27,7 @@ typedef struct {
     char time_br[12];    // Brasília
     uint32_t time_seconds;
     double velocity;     // km/h
+    double course;       // graus, rumo verdadeiro (horário a partir do norte)
     bool valid_fix;
     char status;         // 'A' = Active, 'V' = Void
     char satellites[4];
@@ -34,6 +36,7 @@ typedef struct {
 
 // Funções públicas principais
 void gps_init(void);
+void gps_pps_init(void);  // Timepulse do NEO-6 no GPIO 15 disciplinando a hora
 void read_gps_data(void);
 void read_gps_data_debug(void);
 void read_gps_data_zgps_debug(void);
@@ -43,10 +46,26 @@ void display_gps_data(void);
 // Funções específicas para seus dados (mais simples)
 bool is_gps_valid(void);
 uint32_t get_gps_time_seconds(void);
+// Hora no instante time_us do relógio do Pico (time_us_64), desde 0h: pelo
+// relógio disciplinado com o PPS travado, senão pela referência do último
+// RMC com fix. false enquanto não há referência.
+bool get_gps_utc_us(uint64_t time_us, uint64_t *utc_us);
+bool get_gps_utc_ms(uint64_t time_us, uint32_t *utc_ms);
+bool get_gps_time_ms(uint64_t time_us, uint32_t *br_ms);  // Brasília
 double get_gps_x(void);
 double get_gps_y(void);
 double get_gps_z(void);
+uint32_t get_gps_altitude_updates(void);  // Muda a cada altitude nova do GGA
+uint64_t get_gps_altitude_time_us(void);  // time_us_64 da chegada do '$' desse GGA (0 = sem marca)
 double get_gps_velocity(void);
+double get_gps_course(void);
+uint32_t get_gps_position_updates(void);  // Muda a cada fix novo do RMC
 
 int get_gps_satellites(void);
+
+// Diagnóstico da recepção (bytes perdidos no buffer circular + estouros da FIFO)
+uint32_t get_gps_overflow_count(void);
+void gps_print_stats(void);
+bool is_gps_pps_locked(void);
+void gps_pps_print_stats(void);  // PPS|travado|pulsos|rejeitados|deriva_ppm|residuo_us|residuo_rms_us
 #endif // GPS_NEO_6_H
\ No newline at end of file
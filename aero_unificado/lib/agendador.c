@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include "agendador.h"
+#include "hardware/sync.h"
+#include "desempenho.h"
+
+static int64_t AERO_RAM_FUNC(agendador_alarme_cb)(alarm_id_t id, void *user_data) {
+    agendador_t *ag = (agendador_t *)user_data;
+    ag->alarme_disparado = true;
+    __sev();
+    return 0;  // Não repetir: o próximo alarme é armado pelo agendador
+}
+
+void agendador_inicializar(agendador_t *ag, tarefa_t *tarefas, uint num_tarefas) {
+    ag->tarefas = tarefas;
+    ag->num_tarefas = num_tarefas;
+    ag->alarme_disparado = false;
+    ag->pool = alarm_pool_create_with_unused_hardware_alarm(4);
+
+    uint64_t agora = time_us_64();
+    for (uint i = 0; i < num_tarefas; i++) {
+        tarefas[i].proxima_us = agora;
+    }
+    agendador_zerar_estatisticas(ag);
+}
+
+static void AERO_RAM_FUNC(agendador_rodar_tarefa)(tarefa_t *t, uint64_t agora) {
+    // Atraso maior que um período: descarta as liberações perdidas e
+    // realinha na grade original (sem deslizar a fase)
+    if (agora - t->proxima_us >= t->periodo_us) {
+        uint64_t perdidas = (agora - t->proxima_us) / t->periodo_us;
+        t->perdidas += (uint32_t)perdidas;
+        t->proxima_us += perdidas * t->periodo_us;
+    }
+
+    uint32_t latencia = (uint32_t)(agora - t->proxima_us);
+    uint64_t prazo = t->proxima_us + (t->prazo_us ? t->prazo_us : t->periodo_us);
+
+    t->funcao(t->contexto);
+
+    uint64_t fim = time_us_64();
+    uint32_t duracao = (uint32_t)(fim - agora);
+
+    t->execucoes++;
+    if (fim > prazo) t->atrasos++;
+    if (latencia > t->latencia_max_us) t->latencia_max_us = latencia;
+    if (duracao > t->duracao_max_us) t->duracao_max_us = duracao;
+
+    // Atraso menor que um período: a próxima liberação pode já ter passado,
+    // e a tarefa roda de novo logo em seguida para recuperar
+    t->proxima_us += t->periodo_us;
+}
+
+void AERO_RAM_FUNC(agendador_passo)(agendador_t *ag) {
+    uint64_t agora = time_us_64();
+    uint64_t proxima = UINT64_MAX;
+
+    for (uint i = 0; i < ag->num_tarefas; i++) {
+        tarefa_t *t = &ag->tarefas[i];
+        if (t->proxima_us <= agora) {
+            agendador_rodar_tarefa(t, agora);
+            return;
+        }
+        if (t->proxima_us < proxima) proxima = t->proxima_us;
+    }
+
+    // Nenhuma tarefa pronta: dormir até o alarme da próxima liberação
+    ag->alarme_disparado = false;
+    alarm_id_t id = alarm_pool_add_alarm_at(ag->pool, from_us_since_boot(proxima),
+                                            agendador_alarme_cb, ag, true);
+    if (id > 0) {
+        while (!ag->alarme_disparado) __wfe();
+    }
+}
+
+void agendador_executar(agendador_t *ag) {
+    while (true) {
+        agendador_passo(ag);
+    }
+}
+
+void agendador_imprimir_estatisticas(const agendador_t *ag) {
+    for (uint i = 0; i < ag->num_tarefas; i++) {
+        const tarefa_t *t = &ag->tarefas[i];
+        printf("SCH|%s|%u|%u|%u|%u|%u\n",
+               t->nome, t->execucoes, t->atrasos, t->perdidas,
+               t->latencia_max_us, t->duracao_max_us);
+    }
+}
+
+void agendador_zerar_estatisticas(agendador_t *ag) {
+    for (uint i = 0; i < ag->num_tarefas; i++) {
+        tarefa_t *t = &ag->tarefas[i];
+        t->execucoes = 0;
+        t->atrasos = 0;
+        t->perdidas = 0;
+        t->latencia_max_us = 0;
+        t->duracao_max_us = 0;
+    }
+}
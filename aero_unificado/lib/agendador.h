@@ -0,0 +1,50 @@
+#ifndef AGENDADOR_H
+#define AGENDADOR_H
+
+#include "pico/stdlib.h"
+
+// Função executada a cada liberação de uma tarefa
+typedef void (*tarefa_funcao_t)(void *contexto);
+
+// Tarefa periódica. Preencher nome, periodo_us, prazo_us, funcao e contexto;
+// os demais campos são mantidos pelo agendador.
+typedef struct {
+    const char *nome;
+    uint32_t periodo_us;        // Intervalo entre liberações
+    uint32_t prazo_us;          // Prazo relativo à liberação (0 = igual ao período)
+    tarefa_funcao_t funcao;
+    void *contexto;
+
+    uint64_t proxima_us;        // Próxima liberação (us desde o boot)
+    uint32_t execucoes;
+    uint32_t atrasos;           // Execuções que terminaram depois do prazo
+    uint32_t perdidas;          // Liberações descartadas (atraso > 1 período)
+    uint32_t latencia_max_us;   // Maior espera entre liberação e início
+    uint32_t duracao_max_us;    // Maior tempo de execução
+} tarefa_t;
+
+// Agendador cooperativo por prazos. A ordem da tabela define a prioridade:
+// entre tarefas liberadas, a primeira da tabela roda primeiro. Entre
+// liberações o núcleo dorme em WFE até o alarme de hardware da próxima.
+typedef struct {
+    tarefa_t *tarefas;
+    uint num_tarefas;
+    alarm_pool_t *pool;
+    volatile bool alarme_disparado;
+} agendador_t;
+
+// Cria o pool de alarmes no núcleo que chamar esta função
+void agendador_inicializar(agendador_t *ag, tarefa_t *tarefas, uint num_tarefas);
+
+// Executa no máximo uma tarefa liberada; se nenhuma estiver pronta,
+// dorme até a próxima liberação
+void agendador_passo(agendador_t *ag);
+
+// Laço infinito de agendador_passo()
+void agendador_executar(agendador_t *ag);
+
+// Estatísticas: SCH|nome|execucoes|atrasos|perdidas|latencia_max_us|duracao_max_us
+void agendador_imprimir_estatisticas(const agendador_t *ag);
+void agendador_zerar_estatisticas(agendador_t *ag);
+
+#endif
@@ -0,0 +1,116 @@
+#include "ahrs.h"
+#include "matematica_rapida.h"
+#include "codigo_ram.h"
+
+#define REJEICAO_MIN2 ((1.0f - AHRS_REJEICAO_G) * (1.0f - AHRS_REJEICAO_G) * GRAVIDADE * GRAVIDADE)
+#define REJEICAO_MAX2 ((1.0f + AHRS_REJEICAO_G) * (1.0f + AHRS_REJEICAO_G) * GRAVIDADE * GRAVIDADE)
+
+static void normalizar_quaternion(float *q) {
+    float n = mat_rsqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+    q[0] *= n; q[1] *= n; q[2] *= n; q[3] *= n;
+}
+
+void ahrs_inicializar(ahrs_t *ahrs, float kp, float ki) {
+    ahrs->q[0] = 1.0f;
+    ahrs->q[1] = ahrs->q[2] = ahrs->q[3] = 0.0f;
+    ahrs->integral[0] = ahrs->integral[1] = ahrs->integral[2] = 0.0f;
+    ahrs->kp = kp;
+    ahrs->ki = ki;
+    ahrs->rejeicoes = 0;
+}
+
+void ahrs_alinhar(ahrs_t *ahrs, const float aceleracao[3]) {
+    float n2 = aceleracao[0]*aceleracao[0] + aceleracao[1]*aceleracao[1] + aceleracao[2]*aceleracao[2];
+    if (n2 == 0.0f) return;
+    float n = mat_rsqrt(n2);
+    float ax = aceleracao[0] * n, ay = aceleracao[1] * n, az = aceleracao[2] * n;
+
+    // Menor rotação que leva o eixo z até a gravidade medida (yaw = 0)
+    if (az < -0.9999f) {
+        ahrs->q[0] = 0.0f; ahrs->q[1] = 1.0f; ahrs->q[2] = 0.0f; ahrs->q[3] = 0.0f;
+    } else {
+        ahrs->q[0] = 1.0f + az;
+        ahrs->q[1] = ay;
+        ahrs->q[2] = -ax;
+        ahrs->q[3] = 0.0f;
+        normalizar_quaternion(ahrs->q);
+    }
+    ahrs->integral[0] = ahrs->integral[1] = ahrs->integral[2] = 0.0f;
+}
+
+void AERO_RAM_FUNC(ahrs_atualizar)(ahrs_t *ahrs, const float aceleracao[3], const float giro[3], float dt) {
+    float *q = ahrs->q;
+    float gx = giro[0] * MAT_GRAUS_PARA_RAD;
+    float gy = giro[1] * MAT_GRAUS_PARA_RAD;
+    float gz = giro[2] * MAT_GRAUS_PARA_RAD;
+
+    float n2 = aceleracao[0]*aceleracao[0] + aceleracao[1]*aceleracao[1] + aceleracao[2]*aceleracao[2];
+    if (n2 > REJEICAO_MIN2 && n2 < REJEICAO_MAX2) {
+        float n = mat_rsqrt(n2);
+        float ax = aceleracao[0] * n, ay = aceleracao[1] * n, az = aceleracao[2] * n;
+
+        // Metade da gravidade estimada pelo quaternion
+        float vx = q[1]*q[3] - q[0]*q[2];
+        float vy = q[0]*q[1] + q[2]*q[3];
+        float vz = q[0]*q[0] - 0.5f + q[3]*q[3];
+
+        // Erro = medida x estimada
+        float ex = ay*vz - az*vy;
+        float ey = az*vx - ax*vz;
+        float ez = ax*vy - ay*vx;
+
+        if (ahrs->ki > 0.0f) {
+            ahrs->integral[0] += 2.0f * ahrs->ki * ex * dt;
+            ahrs->integral[1] += 2.0f * ahrs->ki * ey * dt;
+            ahrs->integral[2] += 2.0f * ahrs->ki * ez * dt;
+            gx += ahrs->integral[0];
+            gy += ahrs->integral[1];
+            gz += ahrs->integral[2];
+        }
+        gx += 2.0f * ahrs->kp * ex;
+        gy += 2.0f * ahrs->kp * ey;
+        gz += 2.0f * ahrs->kp * ez;
+    } else {
+        ahrs->rejeicoes++;
+    }
+
+    // q' = q + 0.5 * q * (0, w) * dt
+    gx *= 0.5f * dt;
+    gy *= 0.5f * dt;
+    gz *= 0.5f * dt;
+    float qa = q[0], qb = q[1], qc = q[2];
+    q[0] += -qb*gx - qc*gy - q[3]*gz;
+    q[1] +=  qa*gx + qc*gz - q[3]*gy;
+    q[2] +=  qa*gy - qb*gz + q[3]*gx;
+    q[3] +=  qa*gz + qb*gy - qc*gx;
+    normalizar_quaternion(q);
+}
+
+void AERO_RAM_FUNC(ahrs_gravidade)(const ahrs_t *ahrs, float gravidade[3]) {
+    const float *q = ahrs->q;
+    gravidade[0] = 2.0f * (q[1]*q[3] - q[0]*q[2]);
+    gravidade[1] = 2.0f * (q[0]*q[1] + q[2]*q[3]);
+    gravidade[2] = q[0]*q[0] - q[1]*q[1] - q[2]*q[2] + q[3]*q[3];
+}
+
+void AERO_RAM_FUNC(ahrs_para_terra)(const ahrs_t *ahrs, const float corpo[3], float terra[3]) {
+    const float *q = ahrs->q;
+    float x = corpo[0], y = corpo[1], z = corpo[2];
+    terra[0] = (1.0f - 2.0f * (q[2]*q[2] + q[3]*q[3])) * x + 2.0f * (q[1]*q[2] - q[0]*q[3]) * y
+             + 2.0f * (q[1]*q[3] + q[0]*q[2]) * z;
+    terra[1] = 2.0f * (q[1]*q[2] + q[0]*q[3]) * x + (1.0f - 2.0f * (q[1]*q[1] + q[3]*q[3])) * y
+             + 2.0f * (q[2]*q[3] - q[0]*q[1]) * z;
+    terra[2] = 2.0f * (q[1]*q[3] - q[0]*q[2]) * x + 2.0f * (q[0]*q[1] + q[2]*q[3]) * y
+             + (1.0f - 2.0f * (q[1]*q[1] + q[2]*q[2])) * z;
+}
+
+float ahrs_guinada_graus(const ahrs_t *ahrs) {
+    const float *q = ahrs->q;
+    return mat_atan2_graus(2.0f * (q[1]*q[2] + q[0]*q[3]), 1.0f - 2.0f * (q[2]*q[2] + q[3]*q[3]));
+}
+
+void ahrs_angulos_graus(const float gravidade[3], float *theta, float *phi) {
+    float gx = gravidade[0], gy = gravidade[1], gz = gravidade[2];
+    *theta = mat_atan2_graus(gx, mat_sqrt(gy*gy + gz*gz));
+    *phi = mat_atan2_graus(gy, gz);
+}
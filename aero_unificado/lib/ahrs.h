@@ -0,0 +1,57 @@
+#ifndef AHRS_H
+#define AHRS_H
+
+#include <stdint.h>
+
+// AHRS por quaternion com o filtro de Mahony (realimentação PI do erro
+// entre a gravidade medida e a estimada). Só float, sem trigonometria na
+// atualização: normalizações por mat_rsqrt. Usa os três eixos do giro e
+// vale em qualquer atitude; os ângulos saem sob demanda, na taxa da
+// telemetria.
+//
+// Kp em rad/s é a banda de cruzamento acelerômetro/giro (Kp ~ 1/tau do
+// filtro complementar); Ki estima o resíduo de bias do giro.
+#ifndef AHRS_KP_PADRAO
+#define AHRS_KP_PADRAO 2.0f
+#endif
+#ifndef AHRS_KI_PADRAO
+#define AHRS_KI_PADRAO 0.05f
+#endif
+
+// Fora de (1 ± AHRS_REJEICAO_G) g o acelerômetro está medindo manobra, não
+// gravidade: a atualização só integra o giro
+#define AHRS_REJEICAO_G 0.3f
+
+typedef struct {
+    float q[4];          // w, x, y, z: do referencial da Terra para o do sensor
+    float integral[3];   // Termo integral (rad/s)
+    float kp;
+    float ki;
+    uint32_t rejeicoes;  // Atualizações sem correção do acelerômetro
+} ahrs_t;
+
+void ahrs_inicializar(ahrs_t *ahrs, float kp, float ki);
+
+// Atitude inicial direto do vetor gravidade (sensor parado)
+void ahrs_alinhar(ahrs_t *ahrs, const float aceleracao[3]);
+
+// Uma amostra da IMU: aceleração em m/s², giro em °/s
+void ahrs_atualizar(ahrs_t *ahrs, const float aceleracao[3], const float giro[3], float dt);
+
+// Direção unitária da gravidade no referencial do sensor (a leitura do
+// acelerômetro parado, normalizada); barata para decimar por amostra
+void ahrs_gravidade(const ahrs_t *ahrs, float gravidade[3]);
+
+// Vetor do referencial do sensor para o da Terra (z para cima, guinada
+// arbitrária: sem magnetômetro o norte não é observável)
+void ahrs_para_terra(const ahrs_t *ahrs, const float corpo[3], float terra[3]);
+
+// Guinada do eixo x do sensor no referencial da Terra da AHRS, anti-horária
+// vista de cima. Deriva com o bias do giro z; vale para intervalos curtos.
+float ahrs_guinada_graus(const ahrs_t *ahrs);
+
+// theta/phi com a mesma definição dos ângulos do acelerômetro no filtro
+// complementar: theta em ±90°, phi em ±180°
+void ahrs_angulos_graus(const float gravidade[3], float *theta, float *phi);
+
+#endif
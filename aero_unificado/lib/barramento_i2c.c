@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include "barramento_i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "desempenho.h"
+
+#define MEIO_PERIODO_RECUPERACAO_US 5  // SCL de recuperação a ~100 kHz
+#define TAMANHO_MAX_ESCRITA 40  // Maior escrita intercalada do driver BME680
+
+static void configurar_pinos_i2c(dispositivo_i2c_t *d) {
+    gpio_set_function(d->sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(d->scl_pin, GPIO_FUNC_I2C);
+    gpio_pull_up(d->sda_pin);
+    gpio_pull_up(d->scl_pin);
+}
+
+void i2c_dispositivo_inicializar(dispositivo_i2c_t *d) {
+    i2c_init(d->i2c, d->baudrate);
+    configurar_pinos_i2c(d);
+}
+
+// Dispositivo com DMA ativo em cada controlador, para a IRQ compartilhada
+static dispositivo_i2c_t *dma_dispositivos[2] = {NULL, NULL};
+
+// Limite de uma fase: base do dispositivo + tempo de 'tamanho' bytes no barramento
+static uint32_t AERO_RAM_FUNC(timeout_transacao)(const dispositivo_i2c_t *d, uint16_t tamanho) {
+    return d->timeout_us + (uint32_t)((uint64_t)tamanho * 9 * 1000000 / d->baudrate);
+}
+
+// Contabiliza o resultado de uma transação e dispara a recuperação se
+// o dispositivo acumular falhas seguidas
+static bool AERO_RAM_FUNC(registrar_resultado)(dispositivo_i2c_t *d, int resultado, int esperado, uint32_t inicio_us) {
+    uint32_t latencia = time_us_32() - inicio_us;
+    d->transacoes++;
+    if (latencia > d->latencia_max_us) d->latencia_max_us = latencia;
+
+    if (resultado == esperado) {
+        d->falhas_consecutivas = 0;
+        return true;
+    }
+
+    d->erros++;
+    if (resultado == PICO_ERROR_TIMEOUT) d->timeouts++;
+    d->falhas_consecutivas++;
+
+    if (d->falhas_para_recuperar && d->falhas_consecutivas >= d->falhas_para_recuperar &&
+        !d->em_recuperacao) {
+        i2c_barramento_recuperar(d);
+    }
+    return false;
+}
+
+bool AERO_RAM_FUNC(i2c_dispositivo_escrever_registrador)(dispositivo_i2c_t *d, uint8_t reg, const uint8_t *dados, uint16_t tamanho) {
+    uint8_t buf[TAMANHO_MAX_ESCRITA + 1];
+    if (tamanho > TAMANHO_MAX_ESCRITA) return false;
+
+    buf[0] = reg;
+    for (int i = 0; i < tamanho; i++) buf[i + 1] = dados[i];
+
+    uint32_t inicio = time_us_32();
+    int resultado = i2c_write_timeout_us(d->i2c, d->endereco, buf, tamanho + 1, false,
+                                         timeout_transacao(d, tamanho + 1));
+    return registrar_resultado(d, resultado, tamanho + 1, inicio);
+}
+
+bool AERO_RAM_FUNC(i2c_dispositivo_ler_registrador)(dispositivo_i2c_t *d, uint8_t reg, uint8_t *dados, uint16_t tamanho) {
+    uint32_t inicio = time_us_32();
+    int resultado = i2c_write_timeout_us(d->i2c, d->endereco, &reg, 1, true, d->timeout_us);
+    if (resultado != 1) return registrar_resultado(d, resultado, 1, inicio);
+
+    resultado = i2c_read_timeout_us(d->i2c, d->endereco, dados, tamanho, false,
+                                    timeout_transacao(d, tamanho));
+    return registrar_resultado(d, resultado, tamanho, inicio);
+}
+
+// Desabilita o controlador e espera IC_EN cair: só então a transação em
+// curso terminou, as FIFOs foram esvaziadas e TAR pode ser escrito
+static void AERO_RAM_FUNC(controlador_desabilitar)(const dispositivo_i2c_t *d, i2c_hw_t *hw) {
+    hw->enable = 0;
+    uint32_t inicio = time_us_32();
+    while ((hw->enable_status & I2C_IC_ENABLE_STATUS_IC_EN_BITS) &&
+           time_us_32() - inicio < d->timeout_us) {
+        tight_loop_contents();
+    }
+}
+
+static void AERO_RAM_FUNC(i2c_dma_irq)(void) {
+    for (int i = 0; i < 2; i++) {
+        dispositivo_i2c_t *d = dma_dispositivos[i];
+        if (d && dma_channel_get_irq0_status(d->dma_rx)) {
+            dma_channel_acknowledge_irq0(d->dma_rx);
+            d->dma_concluida = true;
+        }
+    }
+}
+
+void i2c_dispositivo_dma_inicializar(dispositivo_i2c_t *d) {
+    static bool irq_instalada = false;
+
+    d->dma_tx = dma_claim_unused_channel(true);
+    d->dma_rx = dma_claim_unused_channel(true);
+    d->dma_em_andamento = false;
+    d->dma_concluida = false;
+    dma_dispositivos[i2c_get_index(d->i2c)] = d;
+
+    dma_channel_set_irq0_enabled(d->dma_rx, true);
+    if (!irq_instalada) {
+        irq_add_shared_handler(DMA_IRQ_0, i2c_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        irq_instalada = true;
+    }
+}
+
+bool AERO_RAM_FUNC(i2c_dispositivo_iniciar_leitura_dma)(dispositivo_i2c_t *d, uint8_t reg, uint8_t *dados, uint16_t tamanho) {
+    if (d->dma_em_andamento || d->reinicializacao_pendente ||
+        tamanho == 0 || tamanho > I2C_DMA_MAX_BYTES) return false;
+
+    i2c_hw_t *hw = i2c_get_hw(d->i2c);
+
+    // Endereço do escravo só pode mudar com o controlador desabilitado
+    controlador_desabilitar(d, hw);
+    hw->tar = d->endereco;
+    hw->enable = 1;
+    (void)hw->clr_tx_abrt;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+
+    // Um comando de leitura por byte: RESTART no primeiro, STOP no último
+    for (int i = 0; i < tamanho; i++) {
+        d->dma_comandos[i] = I2C_IC_DATA_CMD_CMD_BITS;
+    }
+    d->dma_comandos[0] |= I2C_IC_DATA_CMD_RESTART_BITS;
+    d->dma_comandos[tamanho - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    dma_channel_config rx = dma_channel_get_default_config(d->dma_rx);
+    channel_config_set_transfer_data_size(&rx, DMA_SIZE_8);
+    channel_config_set_read_increment(&rx, false);
+    channel_config_set_write_increment(&rx, true);
+    channel_config_set_dreq(&rx, i2c_get_dreq(d->i2c, false));
+
+    dma_channel_config tx = dma_channel_get_default_config(d->dma_tx);
+    channel_config_set_transfer_data_size(&tx, DMA_SIZE_32);
+    channel_config_set_read_increment(&tx, true);
+    channel_config_set_write_increment(&tx, false);
+    channel_config_set_dreq(&tx, i2c_get_dreq(d->i2c, true));
+
+    d->dma_tamanho = tamanho;
+    d->dma_concluida = false;
+    d->dma_em_andamento = true;
+    d->dma_inicio_us = time_us_32();
+
+    // O RX fica armado antes de qualquer byte chegar; o endereço do
+    // registrador entra na FIFO antes dos comandos de leitura
+    dma_channel_configure(d->dma_rx, &rx, dados, &hw->data_cmd, tamanho, true);
+    hw->data_cmd = reg;
+    dma_channel_configure(d->dma_tx, &tx, &hw->data_cmd, d->dma_comandos, tamanho, true);
+    return true;
+}
+
+bool AERO_RAM_FUNC(i2c_dispositivo_aguardar_dma)(dispositivo_i2c_t *d) {
+    if (!d->dma_em_andamento) return false;
+
+    i2c_hw_t *hw = i2c_get_hw(d->i2c);
+    bool abortada = false;
+    while (!d->dma_concluida) {
+        if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+            abortada = true;
+            break;
+        }
+        if (time_us_32() - d->dma_inicio_us > timeout_transacao(d, d->dma_tamanho + 1)) break;
+        tight_loop_contents();
+    }
+
+    d->dma_em_andamento = false;
+    if (d->dma_concluida) {
+        return registrar_resultado(d, d->dma_tamanho, d->dma_tamanho, d->dma_inicio_us);
+    }
+
+    // Comandos e bytes restantes nas FIFOs seriam lidos pela próxima
+    // transação: descartados com o controlador desabilitado, que volta
+    // sem DMA para as transferências bloqueantes
+    dma_channel_abort(d->dma_tx);
+    dma_channel_abort(d->dma_rx);
+    dma_channel_acknowledge_irq0(d->dma_rx);
+    controlador_desabilitar(d, hw);
+    hw->dma_cr = 0;
+    (void)hw->clr_tx_abrt;
+    hw->enable = 1;
+    return registrar_resultado(d, abortada ? PICO_ERROR_GENERIC : PICO_ERROR_TIMEOUT,
+                               d->dma_tamanho, d->dma_inicio_us);
+}
+
+// SDA e SCL em dreno aberto: nível baixo = saída em 0, nível alto = entrada com pull-up
+static void linha_soltar(uint pino) {
+    gpio_set_dir(pino, GPIO_IN);
+}
+
+static void linha_baixar(uint pino) {
+    gpio_put(pino, 0);
+    gpio_set_dir(pino, GPIO_OUT);
+}
+
+void i2c_barramento_recuperar(dispositivo_i2c_t *d) {
+    d->em_recuperacao = true;
+    d->recuperacoes++;
+
+    i2c_deinit(d->i2c);
+    gpio_init(d->sda_pin);
+    gpio_init(d->scl_pin);
+    gpio_pull_up(d->sda_pin);
+    gpio_pull_up(d->scl_pin);
+    linha_soltar(d->sda_pin);
+    linha_soltar(d->scl_pin);
+    busy_wait_us_32(MEIO_PERIODO_RECUPERACAO_US);
+
+    // Pulsos de clock até o escravo terminar o byte em andamento e soltar SDA
+    for (int i = 0; i < 9 && !gpio_get(d->sda_pin); i++) {
+        linha_baixar(d->scl_pin);
+        busy_wait_us_32(MEIO_PERIODO_RECUPERACAO_US);
+        linha_soltar(d->scl_pin);
+        busy_wait_us_32(MEIO_PERIODO_RECUPERACAO_US);
+    }
+
+    // STOP: SDA sobe com SCL em nível alto
+    linha_baixar(d->sda_pin);
+    busy_wait_us_32(MEIO_PERIODO_RECUPERACAO_US);
+    linha_soltar(d->scl_pin);
+    busy_wait_us_32(MEIO_PERIODO_RECUPERACAO_US);
+    linha_soltar(d->sda_pin);
+    busy_wait_us_32(MEIO_PERIODO_RECUPERACAO_US);
+
+    i2c_dispositivo_inicializar(d);
+    if (d->reinicializar) {
+        d->reinicializacao_pendente = true;
+        d->etapa_reinicializacao = 0;
+        d->proxima_etapa_us = time_us_32();
+    }
+
+    d->falhas_consecutivas = 0;
+    d->em_recuperacao = false;
+}
+
+bool AERO_RAM_FUNC(i2c_dispositivo_manter)(dispositivo_i2c_t *d) {
+    if (!d->reinicializacao_pendente) return true;
+    if ((int32_t)(time_us_32() - d->proxima_etapa_us) < 0) return false;
+
+    uint32_t espera_us = d->reinicializar(d->contexto, d->etapa_reinicializacao++);
+    if (espera_us == 0) {
+        d->reinicializacao_pendente = false;
+        return true;
+    }
+    d->proxima_etapa_us = time_us_32() + espera_us;
+    return false;
+}
+
+void i2c_dispositivo_imprimir_estatisticas(const dispositivo_i2c_t *d) {
+    printf("I2C|%s|%u|%u|%u|%u|%u\n",
+           d->nome, d->transacoes, d->erros, d->timeouts,
+           d->recuperacoes, d->latencia_max_us);
+}
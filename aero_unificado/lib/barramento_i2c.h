@@ -0,0 +1,89 @@
+#ifndef BARRAMENTO_I2C_H
+#define BARRAMENTO_I2C_H
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+#define I2C_DMA_MAX_BYTES 192  // Maior leitura assíncrona suportada (16 amostras da FIFO do MPU6500)
+
+// Dispositivo em um barramento I2C com tempo limite por transação,
+// contadores de erro e recuperação automática do barramento
+typedef struct {
+    const char *nome;
+    i2c_inst_t *i2c;
+    uint8_t endereco;
+    uint sda_pin;
+    uint scl_pin;
+    uint32_t baudrate;
+    uint32_t timeout_us;              // Limite de cada fase, somado ao tempo dos bytes no barramento
+    uint8_t falhas_para_recuperar;    // Falhas seguidas antes de recuperar o barramento
+
+    // Reconfiguração do sensor depois da recuperação (pode ser NULL), em
+    // etapas que não esperam: executa a 'etapa' e retorna os us até a
+    // próxima, ou 0 quando terminou. As esperas do sensor viram prazos de
+    // i2c_dispositivo_manter, e a aquisição não trava.
+    uint32_t (*reinicializar)(void *contexto, uint8_t etapa);
+    void *contexto;
+    bool reinicializacao_pendente;
+    uint8_t etapa_reinicializacao;
+    uint32_t proxima_etapa_us;
+
+    // Estatísticas
+    uint32_t transacoes;
+    uint32_t erros;
+    uint32_t timeouts;
+    uint32_t recuperacoes;
+    uint32_t latencia_max_us;
+    uint8_t falhas_consecutivas;
+    bool em_recuperacao;
+
+    // Leitura assíncrona por DMA (canais alocados em i2c_dispositivo_dma_inicializar)
+    int dma_tx;
+    int dma_rx;
+    uint32_t dma_comandos[I2C_DMA_MAX_BYTES];
+    uint16_t dma_tamanho;
+    uint32_t dma_inicio_us;
+    bool dma_em_andamento;
+    volatile bool dma_concluida;  // Sinalizada pela IRQ do canal de RX
+} dispositivo_i2c_t;
+
+// Configura o controlador e os pinos (com pull-up)
+void i2c_dispositivo_inicializar(dispositivo_i2c_t *d);
+
+// Transações com tempo limite; retornam false em erro ou timeout
+bool i2c_dispositivo_escrever_registrador(dispositivo_i2c_t *d, uint8_t reg, const uint8_t *dados, uint16_t tamanho);
+bool i2c_dispositivo_ler_registrador(dispositivo_i2c_t *d, uint8_t reg, uint8_t *dados, uint16_t tamanho);
+
+// Aloca os canais de DMA do dispositivo. Cada controlador (i2c0/i2c1) pode
+// ter uma leitura em andamento, e leituras em controladores diferentes
+// correm em paralelo.
+void i2c_dispositivo_dma_inicializar(dispositivo_i2c_t *d);
+
+// Dispara a leitura de 'tamanho' bytes a partir de 'reg' e retorna
+// imediatamente. 'dados' deve permanecer válido até a conclusão.
+bool i2c_dispositivo_iniciar_leitura_dma(dispositivo_i2c_t *d, uint8_t reg, uint8_t *dados, uint16_t tamanho);
+
+// Flag de conclusão (sem bloquear)
+static inline bool i2c_dispositivo_dma_concluida(const dispositivo_i2c_t *d) {
+    return d->dma_concluida;
+}
+
+// Espera a conclusão até o tempo limite, contabiliza o resultado e, em
+// caso de NACK ou timeout, cancela a transferência. Retorna true se os
+// dados são válidos.
+bool i2c_dispositivo_aguardar_dma(dispositivo_i2c_t *d);
+
+// Libera um escravo travado segurando SDA: até 9 pulsos de SCL por GPIO,
+// condição de STOP e reinicialização do controlador. A do sensor fica
+// pendente, para i2c_dispositivo_manter.
+void i2c_barramento_recuperar(dispositivo_i2c_t *d);
+
+// Executa a etapa vencida da reconfiguração pendente, se houver. Retorna
+// true se o sensor está pronto para leituras; chamar a cada ciclo antes
+// de ler o dispositivo.
+bool i2c_dispositivo_manter(dispositivo_i2c_t *d);
+
+// I2C|nome|transacoes|erros|timeouts|recuperacoes|latencia_max_us
+void i2c_dispositivo_imprimir_estatisticas(const dispositivo_i2c_t *d);
+
+#endif
@@ -39,6 +39,7 @@
 /*! @file bme680.c
  @brief Sensor driver for BME680 sensor */
 #include "bme680.h"
+#include "desempenho.h"
 
 /*!
  * @brief This internal API is used to read the calibrated data from the sensor.
@@ -210,6 +211,18 @@ static float calc_heater_res(uint16_t temp, const struct bme680_dev *dev);
  */
 static int8_t read_field_data(struct bme680_field_data *data, struct bme680_dev *dev);
 
+/*!
+ * @brief This internal API is used to decode and compensate a raw field
+ * data buffer.
+ *
+ * @param[in] buff : Raw buffer of BME680_FIELD_LENGTH bytes.
+ * @param[out] data : Structure instance to hold the data.
+ * @param[in] dev : Structure instance of bme680_dev.
+ *
+ * @return Nothing
+ */
+static void parse_field_data(const uint8_t *buff, struct bme680_field_data *data, struct bme680_dev *dev);
+
 /*!
  * @brief This internal API is used to set the memory page
  * based on register address.
@@ -270,6 +283,29 @@ static int8_t null_ptr_check(const struct bme680_dev *dev);
  */
 static int8_t boundary_check(uint8_t *value, uint8_t min, uint8_t max, struct bme680_dev *dev);
 
+/*!
+ * @brief This internal API updates the shadow copy of the configuration
+ * registers after a successful bus transfer.
+ *
+ * @param[in] reg_addr	: Register address.
+ * @param[in] reg_data	: Register value.
+ * @param[in] dev	: Structure instance of bme680_dev.
+ */
+static void update_shadow(uint8_t reg_addr, uint8_t reg_data, struct bme680_dev *dev);
+
+/*!
+ * @brief This internal API reads a configuration register from the shadow
+ * copy when it is valid, and from the sensor otherwise.
+ *
+ * @param[in] reg_addr	: Register address.
+ * @param[out] reg_data	: Register value.
+ * @param[in] dev	: Structure instance of bme680_dev.
+ *
+ * @return Result of API execution status
+ * @retval zero -> Success / +ve value -> Warning / -ve value -> Error
+ */
+static int8_t get_conf_reg(uint8_t reg_addr, uint8_t *reg_data, struct bme680_dev *dev);
+
 /****************** Global Function Definitions *******************************/
 /*!
  *@brief This API is the entry point.
@@ -303,9 +339,11 @@ int8_t bme680_init(struct bme680_dev *dev)
 /*!
  * @brief This API reads the data from the given register address of the sensor.
  */
-int8_t bme680_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint16_t len, struct bme680_dev *dev)
+int8_t AERO_RAM_FUNC(bme680_get_regs)(uint8_t reg_addr, uint8_t *reg_data, uint16_t len, struct bme680_dev *dev)
 {
 	int8_t rslt;
+	uint8_t start_addr = reg_addr;
+	uint16_t index;
 
 	/* Check for null pointer in the device structure*/
 	rslt = null_ptr_check(dev);
@@ -317,8 +355,12 @@ int8_t bme680_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint16_t len, struct
 				reg_addr = reg_addr | BME680_SPI_RD_MSK;
 		}
 		dev->com_rslt = dev->read(dev->dev_id, reg_addr, reg_data, len);
-		if (dev->com_rslt != 0)
+		if (dev->com_rslt != 0) {
 			rslt = BME680_E_COM_FAIL;
+		} else {
+			for (index = 0; index < len; index++)
+				update_shadow(start_addr + index, reg_data[index], dev);
+		}
 	}
 
 	return rslt;
@@ -328,7 +370,7 @@ int8_t bme680_get_regs(uint8_t reg_addr, uint8_t *reg_data, uint16_t len, struct
  * @brief This API writes the given data to the register address
  * of the sensor.
  */
-int8_t bme680_set_regs(const uint8_t *reg_addr, const uint8_t *reg_data, uint8_t len, struct bme680_dev *dev)
+int8_t AERO_RAM_FUNC(bme680_set_regs)(const uint8_t *reg_addr, const uint8_t *reg_data, uint8_t len, struct bme680_dev *dev)
 {
 	int8_t rslt;
 	/* Length of the temporary buffer is 2*(length of register)*/
@@ -353,8 +395,12 @@ int8_t bme680_set_regs(const uint8_t *reg_addr, const uint8_t *reg_data, uint8_t
 			/* Write the interleaved array */
 			if (rslt == BME680_OK) {
 				dev->com_rslt = dev->write(dev->dev_id, tmp_buff[0], &tmp_buff[1], (2 * len) - 1);
-				if (dev->com_rslt != 0)
+				if (dev->com_rslt != 0) {
 					rslt = BME680_E_COM_FAIL;
+				} else {
+					for (index = 0; index < len; index++)
+						update_shadow(reg_addr[index], reg_data[index], dev);
+				}
 			}
 		} else {
 			rslt = BME680_E_INVALID_LENGTH;
@@ -383,6 +429,8 @@ int8_t bme680_soft_reset(struct bme680_dev *dev)
 		/* Reset the device */
 		if (rslt == BME680_OK) {
 			rslt = bme680_set_regs(&reg_addr, &soft_rst_cmd, 1, dev);
+			/* Registers are back to their reset values */
+			dev->shadow_valid = 0;
 			/* Wait for 5ms */
 			dev->delay_ms(BME680_RESET_PERIOD);
 
@@ -427,7 +475,7 @@ int8_t bme680_set_sensor_settings(uint16_t desired_settings, struct bme680_dev *
 			reg_addr = BME680_CONF_ODR_FILT_ADDR;
 
 			if (rslt == BME680_OK)
-				rslt = bme680_get_regs(reg_addr, &data, 1, dev);
+				rslt = get_conf_reg(reg_addr, &data, dev);
 
 			if (desired_settings & BME680_FILTER_SEL)
 				data = BME680_SET_BITS(data, BME680_FILTER, dev->tph_sett.filter);
@@ -444,7 +492,7 @@ int8_t bme680_set_sensor_settings(uint16_t desired_settings, struct bme680_dev *
 			reg_addr = BME680_CONF_HEAT_CTRL_ADDR;
 
 			if (rslt == BME680_OK)
-				rslt = bme680_get_regs(reg_addr, &data, 1, dev);
+				rslt = get_conf_reg(reg_addr, &data, dev);
 			data = BME680_SET_BITS_POS_0(data, BME680_HCTRL, dev->gas_sett.heatr_ctrl);
 
 			reg_array[count] = reg_addr; /* Append configuration */
@@ -458,7 +506,7 @@ int8_t bme680_set_sensor_settings(uint16_t desired_settings, struct bme680_dev *
 			reg_addr = BME680_CONF_T_P_MODE_ADDR;
 
 			if (rslt == BME680_OK)
-				rslt = bme680_get_regs(reg_addr, &data, 1, dev);
+				rslt = get_conf_reg(reg_addr, &data, dev);
 
 			if (desired_settings & BME680_OST_SEL)
 				data = BME680_SET_BITS(data, BME680_OST, dev->tph_sett.os_temp);
@@ -477,7 +525,7 @@ int8_t bme680_set_sensor_settings(uint16_t desired_settings, struct bme680_dev *
 			reg_addr = BME680_CONF_OS_H_ADDR;
 
 			if (rslt == BME680_OK)
-				rslt = bme680_get_regs(reg_addr, &data, 1, dev);
+				rslt = get_conf_reg(reg_addr, &data, dev);
 			data = BME680_SET_BITS_POS_0(data, BME680_OSH, dev->tph_sett.os_hum);
 
 			reg_array[count] = reg_addr; /* Append configuration */
@@ -498,7 +546,7 @@ int8_t bme680_set_sensor_settings(uint16_t desired_settings, struct bme680_dev *
 			reg_addr = BME680_CONF_ODR_RUN_GAS_NBC_ADDR;
 
 			if (rslt == BME680_OK)
-				rslt = bme680_get_regs(reg_addr, &data, 1, dev);
+				rslt = get_conf_reg(reg_addr, &data, dev);
 
 			if (desired_settings & BME680_RUN_GAS_SEL)
 				data = BME680_SET_BITS(data, BME680_RUN_GAS, dev->gas_sett.run_gas);
@@ -632,6 +680,29 @@ int8_t bme680_get_sensor_mode(struct bme680_dev *dev)
 	return rslt;
 }
 
+/*!
+ * @brief This API triggers a forced mode measurement with a single write.
+ */
+int8_t AERO_RAM_FUNC(bme680_trigger_forced_mode)(struct bme680_dev *dev)
+{
+	int8_t rslt;
+	uint8_t reg_addr = BME680_CONF_T_P_MODE_ADDR;
+	uint8_t ctrl_meas;
+
+	/* Check for null pointer in the device structure*/
+	rslt = null_ptr_check(dev);
+	if (rslt == BME680_OK) {
+		dev->power_mode = BME680_FORCED_MODE;
+		rslt = get_conf_reg(reg_addr, &ctrl_meas, dev);
+		if (rslt == BME680_OK) {
+			ctrl_meas = (ctrl_meas & ~BME680_MODE_MSK) | BME680_FORCED_MODE;
+			rslt = bme680_set_regs(&reg_addr, &ctrl_meas, 1, dev);
+		}
+	}
+
+	return rslt;
+}
+
 /*!
  * @brief This API is used to set the profile duration of the sensor.
  */
@@ -713,6 +784,27 @@ int8_t bme680_get_sensor_data(struct bme680_field_data *data, struct bme680_dev
 	return rslt;
 }
 
+/*!
+ * @brief This API decodes a field data buffer read from BME680_FIELD0_ADDR
+ * by the user (e.g. through an asynchronous transfer).
+ */
+int8_t AERO_RAM_FUNC(bme680_parse_field_data)(const uint8_t *buff, struct bme680_field_data *data, struct bme680_dev *dev)
+{
+	int8_t rslt;
+
+	/* Check for null pointer in the device structure*/
+	rslt = null_ptr_check(dev);
+	if (rslt == BME680_OK) {
+		parse_field_data(buff, data, dev);
+		if (data->status & BME680_NEW_DATA_MSK)
+			dev->new_fields = 1;
+		else
+			dev->new_fields = 0;
+	}
+
+	return rslt;
+}
+
 /*!
  * @brief This internal API is used to read the calibrated data from the sensor.
  */
@@ -864,7 +956,7 @@ static int8_t get_gas_config(struct bme680_dev *dev)
 /*!
  * @brief This internal API is used to calculate the temperature value.
  */
-static int16_t calc_temperature(uint32_t temp_adc, struct bme680_dev *dev)
+static int16_t AERO_RAM_FUNC(calc_temperature)(uint32_t temp_adc, struct bme680_dev *dev)
 {
 	int64_t var1;
 	int64_t var2;
@@ -884,7 +976,7 @@ static int16_t calc_temperature(uint32_t temp_adc, struct bme680_dev *dev)
 /*!
  * @brief This internal API is used to calculate the pressure value.
  */
-static uint32_t calc_pressure(uint32_t pres_adc, const struct bme680_dev *dev)
+static uint32_t AERO_RAM_FUNC(calc_pressure)(uint32_t pres_adc, const struct bme680_dev *dev)
 {
 	int32_t var1;
 	int32_t var2;
@@ -1021,7 +1113,7 @@ static uint8_t calc_heater_res(uint16_t temp, const struct bme680_dev *dev)
  * @brief This internal API is used to calculate the
  * temperature value in float format
  */
-static float calc_temperature(uint32_t temp_adc, struct bme680_dev *dev)
+static float AERO_RAM_FUNC(calc_temperature)(uint32_t temp_adc, struct bme680_dev *dev)
 {
 	float var1 = 0;
 	float var2 = 0;
@@ -1049,7 +1141,7 @@ static float calc_temperature(uint32_t temp_adc, struct bme680_dev *dev)
  * @brief This internal API is used to calculate the
  * pressure value in float format
  */
-static float calc_pressure(uint32_t pres_adc, const struct bme680_dev *dev)
+static float AERO_RAM_FUNC(calc_pressure)(uint32_t pres_adc, const struct bme680_dev *dev)
 {
 	float var1 = 0;
 	float var2 = 0;
@@ -1201,11 +1293,6 @@ static int8_t read_field_data(struct bme680_field_data *data, struct bme680_dev
 {
 	int8_t rslt;
 	uint8_t buff[BME680_FIELD_LENGTH] = { 0 };
-	uint8_t gas_range;
-	uint32_t adc_temp;
-	uint32_t adc_pres;
-	uint16_t adc_hum;
-	uint16_t adc_gas_res;
 	uint8_t tries = 10;
 
 	/* Check for null pointer in the device structure*/
@@ -1215,29 +1302,10 @@ static int8_t read_field_data(struct bme680_field_data *data, struct bme680_dev
 			rslt = bme680_get_regs(((uint8_t) (BME680_FIELD0_ADDR)), buff, (uint16_t) BME680_FIELD_LENGTH,
 				dev);
 
-			data->status = buff[0] & BME680_NEW_DATA_MSK;
-			data->gas_index = buff[0] & BME680_GAS_INDEX_MSK;
-			data->meas_index = buff[1];
-
-			/* read the raw data from the sensor */
-			adc_pres = (uint32_t) (((uint32_t) buff[2] * 4096) | ((uint32_t) buff[3] * 16)
-				| ((uint32_t) buff[4] / 16));
-			adc_temp = (uint32_t) (((uint32_t) buff[5] * 4096) | ((uint32_t) buff[6] * 16)
-				| ((uint32_t) buff[7] / 16));
-			adc_hum = (uint16_t) (((uint32_t) buff[8] * 256) | (uint32_t) buff[9]);
-			adc_gas_res = (uint16_t) ((uint32_t) buff[13] * 4 | (((uint32_t) buff[14]) / 64));
-			gas_range = buff[14] & BME680_GAS_RANGE_MSK;
-
-			data->status |= buff[14] & BME680_GASM_VALID_MSK;
-			data->status |= buff[14] & BME680_HEAT_STAB_MSK;
-
-			if (data->status & BME680_NEW_DATA_MSK) {
-				data->temperature = calc_temperature(adc_temp, dev);
-				data->pressure = calc_pressure(adc_pres, dev);
-				data->humidity = calc_humidity(adc_hum, dev);
-				data->gas_resistance = calc_gas_resistance(adc_gas_res, gas_range, dev);
+			parse_field_data(buff, data, dev);
+			if (data->status & BME680_NEW_DATA_MSK)
 				break;
-			}
+
 			/* Delay to poll the data */
 			dev->delay_ms(BME680_POLL_PERIOD_MS);
 		}
@@ -1250,10 +1318,46 @@ static int8_t read_field_data(struct bme680_field_data *data, struct bme680_dev
 	return rslt;
 }
 
+/*!
+ * @brief This internal API is used to decode and compensate a raw field
+ * data buffer.
+ */
+static void AERO_RAM_FUNC(parse_field_data)(const uint8_t *buff, struct bme680_field_data *data, struct bme680_dev *dev)
+{
+	uint8_t gas_range;
+	uint32_t adc_temp;
+	uint32_t adc_pres;
+	uint16_t adc_hum;
+	uint16_t adc_gas_res;
+
+	data->status = buff[0] & BME680_NEW_DATA_MSK;
+	data->gas_index = buff[0] & BME680_GAS_INDEX_MSK;
+	data->meas_index = buff[1];
+
+	/* read the raw data from the sensor */
+	adc_pres = (uint32_t) (((uint32_t) buff[2] * 4096) | ((uint32_t) buff[3] * 16)
+		| ((uint32_t) buff[4] / 16));
+	adc_temp = (uint32_t) (((uint32_t) buff[5] * 4096) | ((uint32_t) buff[6] * 16)
+		| ((uint32_t) buff[7] / 16));
+	adc_hum = (uint16_t) (((uint32_t) buff[8] * 256) | (uint32_t) buff[9]);
+	adc_gas_res = (uint16_t) ((uint32_t) buff[13] * 4 | (((uint32_t) buff[14]) / 64));
+	gas_range = buff[14] & BME680_GAS_RANGE_MSK;
+
+	data->status |= buff[14] & BME680_GASM_VALID_MSK;
+	data->status |= buff[14] & BME680_HEAT_STAB_MSK;
+
+	if (data->status & BME680_NEW_DATA_MSK) {
+		data->temperature = calc_temperature(adc_temp, dev);
+		data->pressure = calc_pressure(adc_pres, dev);
+		data->humidity = calc_humidity(adc_hum, dev);
+		data->gas_resistance = calc_gas_resistance(adc_gas_res, gas_range, dev);
+	}
+}
+
 /*!
  * @brief This internal API is used to set the memory page based on register address.
  */
-static int8_t set_mem_page(uint8_t reg_addr, struct bme680_dev *dev)
+static int8_t AERO_RAM_FUNC(set_mem_page)(uint8_t reg_addr, struct bme680_dev *dev)
 {
 	int8_t rslt;
 	uint8_t reg;
@@ -1338,11 +1442,47 @@ static int8_t boundary_check(uint8_t *value, uint8_t min, uint8_t max, struct bm
 	return rslt;
 }
 
+/*!
+ * @brief This internal API updates the shadow copy of the configuration
+ * registers after a successful bus transfer.
+ */
+static void AERO_RAM_FUNC(update_shadow)(uint8_t reg_addr, uint8_t reg_data, struct bme680_dev *dev)
+{
+	uint8_t index;
+
+	if ((reg_addr >= BME680_SHADOW_START_ADDR) &&
+		(reg_addr < BME680_SHADOW_START_ADDR + BME680_SHADOW_LENGTH)) {
+		index = reg_addr - BME680_SHADOW_START_ADDR;
+		/* The mode bits change on their own, keep the sleep value */
+		if (reg_addr == BME680_CONF_T_P_MODE_ADDR)
+			reg_data = reg_data & ~BME680_MODE_MSK;
+		dev->shadow_regs[index] = reg_data;
+		dev->shadow_valid |= (uint8_t)(1 << index);
+	}
+}
+
+/*!
+ * @brief This internal API reads a configuration register from the shadow
+ * copy when it is valid, and from the sensor otherwise.
+ */
+static int8_t AERO_RAM_FUNC(get_conf_reg)(uint8_t reg_addr, uint8_t *reg_data, struct bme680_dev *dev)
+{
+	uint8_t index = reg_addr - BME680_SHADOW_START_ADDR;
+
+	if ((reg_addr >= BME680_SHADOW_START_ADDR) && (index < BME680_SHADOW_LENGTH) &&
+		(dev->shadow_valid & (1 << index))) {
+		*reg_data = dev->shadow_regs[index];
+		return BME680_OK;
+	}
+
+	return bme680_get_regs(reg_addr, reg_data, 1, dev);
+}
+
 /*!
  * @brief This internal API is used to validate the device structure pointer for
  * null conditions.
  */
-static int8_t null_ptr_check(const struct bme680_dev *dev)
+static int8_t AERO_RAM_FUNC(null_ptr_check)(const struct bme680_dev *dev)
 {
 	int8_t rslt;
 
@@ -135,6 +135,21 @@ int8_t bme680_set_sensor_mode(struct bme680_dev *dev);
  */
 int8_t bme680_get_sensor_mode(struct bme680_dev *dev);
 
+/*!
+ * @brief This API triggers a forced mode measurement with a single register
+ * write, using the shadow copy of ctrl_meas kept by the driver.
+ *
+ * @param[in] dev : Structure instance of bme680_dev
+ * @note : Unlike bme680_set_sensor_mode(), the sensor is not polled for sleep
+ * mode. Call it only when the sensor is known to be asleep: after
+ * bme680_set_sensor_settings() or once the previous forced measurement
+ * has completed.
+ *
+ * @return Result of API execution status
+ * @retval zero -> Success / +ve value -> Warning / -ve value -> Error
+ */
+int8_t bme680_trigger_forced_mode(struct bme680_dev *dev);
+
 /*!
  * @brief This API is used to set the profile duration of the sensor.
  *
@@ -168,6 +183,20 @@ void bme680_get_profile_dur(uint16_t *duration, const struct bme680_dev *dev);
  */
 int8_t bme680_get_sensor_data(struct bme680_field_data *data, struct bme680_dev *dev);
 
+/*!
+ * @brief This API decodes and compensates a raw field data buffer of
+ * BME680_FIELD_LENGTH bytes read from BME680_FIELD0_ADDR, for users that
+ * read the sensor registers asynchronously.
+ *
+ * @param[in] buff : Raw field data buffer.
+ * @param[out] data : Structure instance to hold the data.
+ * @param[in] dev : Structure instance of bme680_dev.
+ *
+ * @return Result of API execution status
+ * @retval zero -> Success / +ve value -> Warning / -ve value -> Error
+ */
+int8_t bme680_parse_field_data(const uint8_t *buff, struct bme680_field_data *data, struct bme680_dev *dev);
+
 /*!
  * @brief This API is used to set the oversampling, filter and T,P,H, gas selection
  * settings in the sensor.
@@ -1,54 +1,147 @@
 #include <stdio.h>
 #include <math.h>
 #include "bme680_custom.h"
+#include "desempenho.h"
+#include "matematica_rapida.h"
+#include "janela_movel.h"
 
-int8_t user_i2c_write(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
-    uint8_t buf[len + 1];
-    buf[0] = reg_addr;
-    for (int i = 0; i < len; i++) buf[i + 1] = data[i];
-    
-    int result = i2c_write_blocking(I2C_PORT_BME, dev_id, buf, len + 1, false);
-    return result == (len + 1) ? BME680_OK : BME680_E_COM_FAIL;
+#ifdef AERO_BME680_SPI
+bme680_spi_estatisticas_t bme680_spi_stats = {0};
+
+// O driver já aplica BME680_SPI_RD_MSK no endereço e troca a página de
+// memória quando necessário; aqui só se monta o quadro com o CS
+int8_t AERO_RAM_FUNC(user_spi_read)(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+    gpio_put(BME680_SPI_CS_PIN, 0);
+    spi_write_blocking(BME680_SPI_PORT, &reg_addr, 1);
+    spi_read_blocking(BME680_SPI_PORT, 0x00, data, len);
+    gpio_put(BME680_SPI_CS_PIN, 1);
+    bme680_spi_stats.transacoes++;
+    bme680_spi_stats.bytes += len + 1;
+    return BME680_OK;
+}
+
+// Escritas chegam intercaladas (endereço, dado, endereço, dado...) e são
+// enviadas em um único quadro
+int8_t AERO_RAM_FUNC(user_spi_write)(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+    gpio_put(BME680_SPI_CS_PIN, 0);
+    spi_write_blocking(BME680_SPI_PORT, &reg_addr, 1);
+    spi_write_blocking(BME680_SPI_PORT, data, len);
+    gpio_put(BME680_SPI_CS_PIN, 1);
+    bme680_spi_stats.transacoes++;
+    bme680_spi_stats.bytes += len + 1;
+    return BME680_OK;
 }
 
-int8_t user_i2c_read(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
-    int write_result = i2c_write_blocking(I2C_PORT_BME, dev_id, &reg_addr, 1, true);
-    if (write_result != 1) return BME680_E_COM_FAIL;
+static void bme680_barramento_inicializar(struct bme680_dev *sensor) {
+    spi_init(BME680_SPI_PORT, BME680_SPI_BAUD);
+    spi_set_format(BME680_SPI_PORT, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);  // Modo 0
+    gpio_set_function(BME680_SPI_SCK_PIN, GPIO_FUNC_SPI);
+    gpio_set_function(BME680_SPI_MOSI_PIN, GPIO_FUNC_SPI);
+    gpio_set_function(BME680_SPI_MISO_PIN, GPIO_FUNC_SPI);
 
-    int read_result = i2c_read_blocking(I2C_PORT_BME, dev_id, data, len, false);
-    return read_result == len ? BME680_OK : BME680_E_COM_FAIL;
+    // Borda de descida no CSB após o reset seleciona o modo SPI no sensor
+    gpio_init(BME680_SPI_CS_PIN);
+    gpio_put(BME680_SPI_CS_PIN, 1);
+    gpio_set_dir(BME680_SPI_CS_PIN, GPIO_OUT);
+
+    sensor->dev_id = 0;
+    sensor->intf = BME680_SPI_INTF;
+    sensor->read = user_spi_read;
+    sensor->write = user_spi_write;
 }
 
-void user_delay_ms(uint32_t period) {
-    sleep_ms(period);
+// A 10 MHz os 15 bytes de campos levam ~15 us: a leitura é feita na hora
+static bool campos_ok = false;
+
+static bool AERO_RAM_FUNC(bme680_iniciar_leitura_campos)(bme680_leitor_t *leitor) {
+    campos_ok = bme680_get_regs(BME680_FIELD0_ADDR, leitor->campos, BME680_FIELD_LENGTH,
+                                leitor->sensor) == BME680_OK;
+    return campos_ok;
 }
 
-void bme680_inicializar(struct bme680_dev *sensor, uint16_t *periodo) {
-    i2c_init(I2C_PORT_BME, 400 * 1000);  // 400 kHz - mais rápido
-    gpio_set_function(SDA_PIN_BME, GPIO_FUNC_I2C);
-    gpio_set_function(SCL_PIN_BME, GPIO_FUNC_I2C);
-    gpio_pull_up(SDA_PIN_BME);
-    gpio_pull_up(SCL_PIN_BME);
+static bool AERO_RAM_FUNC(bme680_aguardar_leitura_campos)(void) {
+    return campos_ok;
+}
+#else
+static uint32_t bme680_reinicializar(void *contexto, uint8_t etapa);
+
+dispositivo_i2c_t bme680_i2c = {
+    .nome = "BME680",
+    .i2c = I2C_PORT_BME,
+    .endereco = BME680_ADDR,
+    .sda_pin = SDA_PIN_BME,
+    .scl_pin = SCL_PIN_BME,
+    .baudrate = 400 * 1000,  // 400 kHz - mais rápido
+    .timeout_us = BME680_TIMEOUT_US,
+    .falhas_para_recuperar = 3,
+    .reinicializar = bme680_reinicializar,
+};
+
+int8_t AERO_RAM_FUNC(user_i2c_write)(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+    return i2c_dispositivo_escrever_registrador(&bme680_i2c, reg_addr, data, len)
+           ? BME680_OK : BME680_E_COM_FAIL;
+}
+
+int8_t AERO_RAM_FUNC(user_i2c_read)(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+    return i2c_dispositivo_ler_registrador(&bme680_i2c, reg_addr, data, len)
+           ? BME680_OK : BME680_E_COM_FAIL;
+}
+
+static void bme680_barramento_inicializar(struct bme680_dev *sensor) {
+    i2c_dispositivo_inicializar(&bme680_i2c);
+    i2c_dispositivo_dma_inicializar(&bme680_i2c);
+    bme680_i2c.contexto = sensor;
 
     sensor->dev_id = BME680_ADDR;
     sensor->intf = BME680_I2C_INTF;
     sensor->read = user_i2c_read;
     sensor->write = user_i2c_write;
-    sensor->delay_ms = user_delay_ms;
-    sensor->amb_temp = 25; // Temperatura ambiente estimada
+}
 
-    sleep_ms(100);
+// Status e campos vêm na mesma rajada, por DMA no i2c0
+static bool AERO_RAM_FUNC(bme680_iniciar_leitura_campos)(bme680_leitor_t *leitor) {
+    return i2c_dispositivo_iniciar_leitura_dma(&bme680_i2c, BME680_FIELD0_ADDR,
+                                               leitor->campos, BME680_FIELD_LENGTH);
+}
 
-    if (bme680_init(sensor) != BME680_OK) {
-        printf("Erro ao iniciar sensor\n");
-        while (1) tight_loop_contents();
-    }
+static bool AERO_RAM_FUNC(bme680_aguardar_leitura_campos)(void) {
+    return i2c_dispositivo_aguardar_dma(&bme680_i2c);
+}
+#endif
 
-    // Configuração RÁPIDA - oversampling mínimo
-    sensor->tph_sett.os_hum = BME680_OS_NONE;     // Sem umidade
-    sensor->tph_sett.os_pres = BME680_OS_4X;      // 1x pressão (rápido)
-    sensor->tph_sett.os_temp = BME680_OS_1X;      // 1x temperatura
-    sensor->tph_sett.filter = BME680_FILTER_SIZE_3; // Sem filtro IIR
+void user_delay_ms(uint32_t period) {
+    sleep_ms(period);
+}
+
+// Oversampling e filtro IIR de cada perfil. A temperatura entra só na
+// compensação da pressão e não precisa de mais que 2x.
+typedef struct {
+    const char *nome;
+    uint8_t os_pres;
+    uint8_t os_temp;
+    uint8_t filtro;
+} bme680_perfil_config_t;
+
+static const bme680_perfil_config_t perfis[BME680_NUM_PERFIS] = {
+    [BME680_PERFIL_BAIXA_LATENCIA] = { "BAIXA_LATENCIA", BME680_OS_2X,  BME680_OS_1X, BME680_FILTER_SIZE_0 },
+    [BME680_PERFIL_EQUILIBRADO]    = { "EQUILIBRADO",    BME680_OS_4X,  BME680_OS_1X, BME680_FILTER_SIZE_3 },
+    [BME680_PERFIL_BAIXO_RUIDO]    = { "BAIXO_RUIDO",    BME680_OS_16X, BME680_OS_2X, BME680_FILTER_SIZE_15 },
+};
+
+// Reaplicado pela recuperação do barramento
+static bme680_perfil_t perfil_atual = BME680_PERFIL_PADRAO;
+
+const char *bme680_nome_perfil(bme680_perfil_t perfil) {
+    return perfis[perfil].nome;
+}
+
+// Configurações de medição do perfil atual
+static bool bme680_aplicar_configuracoes(struct bme680_dev *sensor) {
+    const bme680_perfil_config_t *p = &perfis[perfil_atual];
+    sensor->tph_sett.os_hum = BME680_OS_NONE;  // Umidade não é usada
+    sensor->tph_sett.os_pres = p->os_pres;
+    sensor->tph_sett.os_temp = p->os_temp;
+    sensor->tph_sett.filter = p->filtro;
 
     // Desabilitar sensor de gás (muito lento)
     sensor->gas_sett.run_gas = BME680_DISABLE_GAS_MEAS;
@@ -58,20 +151,85 @@ void bme680_inicializar(struct bme680_dev *sensor, uint16_t *periodo) {
                   BME680_FILTER_SEL | BME680_GAS_MEAS_SEL | 
                   BME680_HCNTRL_SEL | BME680_RUN_GAS_SEL;
     
-    bme680_set_sensor_settings(sel, sensor);
+    return bme680_set_sensor_settings(sel, sensor) == BME680_OK;
+}
+
+// Carrega a calibração do sensor e aplica as configurações de medição
+static bool bme680_configurar(struct bme680_dev *sensor) {
+    return bme680_init(sensor) == BME680_OK && bme680_aplicar_configuracoes(sensor);
+}
+
+#ifndef AERO_BME680_SPI
+// Etapas chamadas pela camada I2C depois de recuperar o barramento: soft
+// reset sem a espera de bme680_soft_reset() e as configurações depois dele.
+// A calibração carregada no boot continua válida.
+static uint32_t bme680_reinicializar(void *contexto, uint8_t etapa) {
+    struct bme680_dev *sensor = contexto;
+    if (etapa == 0) {
+        uint8_t reg = BME680_SOFT_RESET_ADDR;
+        uint8_t cmd = BME680_SOFT_RESET_CMD;
+        bme680_set_regs(&reg, &cmd, 1, sensor);
+        sensor->shadow_valid = 0;  // Registradores voltaram ao padrão
+        return BME680_RESET_PERIOD * 1000;
+    }
+    bme680_aplicar_configuracoes(sensor);
+    return 0;
+}
+
+static bool AERO_RAM_FUNC(bme680_disponivel)(void) {
+    return i2c_dispositivo_manter(&bme680_i2c);
+}
+#else
+static bool bme680_disponivel(void) {
+    return true;
+}
+#endif
+
+bool bme680_aplicar_perfil(struct bme680_dev *sensor, bme680_perfil_t perfil, uint16_t *periodo) {
+    const bme680_perfil_config_t *p = &perfis[perfil];
+    sensor->tph_sett.os_pres = p->os_pres;
+    sensor->tph_sett.os_temp = p->os_temp;
+    sensor->tph_sett.filter = p->filtro;
+
+    // Com a cópia dos registradores no driver, só as escritas vão ao barramento
+    if (bme680_set_sensor_settings(BME680_OST_SEL | BME680_OSP_SEL | BME680_FILTER_SEL,
+                                   sensor) != BME680_OK) {
+        return false;
+    }
+    perfil_atual = perfil;
+    bme680_get_profile_dur(periodo, sensor);
+    return true;
+}
+
+void bme680_inicializar(struct bme680_dev *sensor, uint16_t *periodo) {
+    bme680_barramento_inicializar(sensor);
+    sensor->delay_ms = user_delay_ms;
+    sensor->amb_temp = 25; // Temperatura ambiente estimada
+
+    sleep_ms(100);
+
+    if (!bme680_configurar(sensor)) {
+        printf("Erro ao iniciar sensor\n");
+        while (1) tight_loop_contents();
+    }
+
     bme680_get_profile_dur(periodo, sensor);
     
-    printf("Tempo de medição BME680: %u ms\n", *periodo);
+    printf("Perfil BME680: %s, medição de %u ms\n", bme680_nome_perfil(perfil_atual), *periodo);
 }
 
 float calibrar_pressao(struct bme680_dev *sensor, uint16_t periodo) {
     printf("Calibrando pressão base (%d amostras)...\n", NUM_CALIBRACAO);
-    float soma = 0.0f;
+    janela_movel_t janela;
+    if (!janela_inicializar(&janela, 1, NUM_CALIBRACAO)) {
+        printf("ERRO: NUM_CALIBRACAO %d acima de JANELA_MAX_AMOSTRAS %d\n", NUM_CALIBRACAO, JANELA_MAX_AMOSTRAS);
+        return -1.0f;
+    }
     int contador_valido = 0;
 
     for (int i = 0; i < NUM_CALIBRACAO && contador_valido < NUM_CALIBRACAO; i++) {
-        sensor->power_mode = BME680_FORCED_MODE;
-        bme680_set_sensor_mode(sensor);
+        // A conversão anterior já terminou: disparo com uma escrita
+        bme680_trigger_forced_mode(sensor);
 
         // Delay baseado no tempo de medição real + margem
         user_delay_ms(periodo + 10);
@@ -80,7 +238,7 @@ float calibrar_pressao(struct bme680_dev *sensor, uint16_t periodo) {
         if (bme680_get_sensor_data(&data, sensor) == BME680_OK) {
             if (data.status & BME680_NEW_DATA_MSK) {
                 float pressao_hpa = data.pressure / 100.0f;
-                soma += pressao_hpa;
+                janela_adicionar(&janela, &pressao_hpa);
                 contador_valido++;
                 
                 if (contador_valido % 10 == 0) {
@@ -91,9 +249,9 @@ float calibrar_pressao(struct bme680_dev *sensor, uint16_t periodo) {
     }
     
     if (contador_valido > 0) {
-        float pressao_media = soma / contador_valido;
-        printf("Calibração completa: %.2f hPa (%d leituras)\n", 
-               pressao_media, contador_valido);
+        float pressao_media = janela_media(&janela, 0);
+        printf("Calibração completa: %.2f hPa (%d leituras, desvio %.3f hPa)\n", 
+               (double)pressao_media, contador_valido, (double)janela_desvio(&janela, 0));
         return pressao_media;
     } else {
         printf("ERRO: Nenhuma leitura válida!\n");
@@ -101,12 +259,37 @@ float calibrar_pressao(struct bme680_dev *sensor, uint16_t periodo) {
     }
 }
 
+bool bme680_medir(struct bme680_dev *sensor, uint16_t periodo, uint8_t amostras,
+                  float *pressao, float *temperatura) {
+    janela_movel_t janela;
+    if (!janela_inicializar(&janela, 2, amostras)) return false;
+
+    for (int i = 0; i < amostras; i++) {
+        bme680_trigger_forced_mode(sensor);
+        user_delay_ms(periodo + 10);
+
+        struct bme680_field_data data;
+        if (bme680_get_sensor_data(&data, sensor) == BME680_OK && (data.status & BME680_NEW_DATA_MSK)) {
+            float leitura[2] = { data.pressure / 100.0f, data.temperature / 100.0f };
+            janela_adicionar(&janela, leitura);
+        }
+    }
+    if (janela.contagem == 0) return false;
+
+    *pressao = janela_media(&janela, 0);
+    *temperatura = janela_media(&janela, 1);
+    return true;
+}
+
+static float AERO_RAM_FUNC(pressao_para_altitude)(float pressao, float pressao_base) {
+    return mat_altitude_razao_pressao(pressao / pressao_base);
+}
+
 bool bme680_ler_altitude(struct bme680_dev *sensor, uint16_t periodo,
                          float pressao_base, float *pressao, float *altitude) {
     struct bme680_field_data dados;
     
-    sensor->power_mode = BME680_FORCED_MODE;
-    bme680_set_sensor_mode(sensor);
+    bme680_trigger_forced_mode(sensor);
     
     // Delay mínimo necessário
     user_delay_ms(periodo + 5);
@@ -114,9 +297,141 @@ bool bme680_ler_altitude(struct bme680_dev *sensor, uint16_t periodo,
     if (bme680_get_sensor_data(&dados, sensor) == BME680_OK &&
         (dados.status & BME680_NEW_DATA_MSK)) {
         *pressao = dados.pressure / 100.0f;
-        float fator = powf(*pressao / pressao_base, 1.0f / 5.255f);
-        *altitude = 44330.0f * (1.0f - fator);
+        *altitude = pressao_para_altitude(*pressao, pressao_base);
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+static uint32_t bme680_transacoes_barramento(void) {
+#ifdef AERO_BME680_SPI
+    return bme680_spi_stats.transacoes;
+#else
+    return bme680_i2c.transacoes;
+#endif
+}
+
+void bme680_leitor_inicializar(bme680_leitor_t *leitor, struct bme680_dev *sensor, uint16_t periodo) {
+    leitor->sensor = sensor;
+    leitor->periodo = periodo;
+    leitor->pronto_em = get_absolute_time();
+    leitor->tempo_us = 0;
+    leitor->em_conversao = false;
+    leitor->coletando = false;
+    leitor->conversoes = 0;
+    leitor->reinicios = 0;
+    leitor->transacoes_inicio = bme680_transacoes_barramento();
+}
+
+bool AERO_RAM_FUNC(bme680_iniciar_conversao)(bme680_leitor_t *leitor) {
+    // Só é chamada com o sensor em sleep (recém configurado ou com a conversão
+    // anterior terminada): uma escrita de ctrl_meas a partir da cópia do driver,
+    // sem a leitura e a espera de bme680_set_sensor_mode()
+    if (bme680_trigger_forced_mode(leitor->sensor) != BME680_OK) {
+        leitor->em_conversao = false;
+        return false;
+    }
+    leitor->pronto_em = make_timeout_time_ms(leitor->periodo);
+    leitor->em_conversao = true;
+    return true;
+}
+
+bool AERO_RAM_FUNC(bme680_iniciar_coleta)(bme680_leitor_t *leitor) {
+    // Em reconfiguração: a conversão em curso se perdeu no reset
+    if (!bme680_disponivel()) {
+        leitor->em_conversao = false;
+        return false;
+    }
+    if (!leitor->em_conversao) {
+        bme680_iniciar_conversao(leitor);
+        return false;
+    }
+    if (!time_reached(leitor->pronto_em)) return false;
+
+    leitor->coletando = bme680_iniciar_leitura_campos(leitor);
+    return leitor->coletando;
+}
+
+bool AERO_RAM_FUNC(bme680_concluir_coleta)(bme680_leitor_t *leitor, float pressao_base,
+                            float *pressao, float *altitude) {
+    if (!leitor->coletando) return false;
+    leitor->coletando = false;
+
+    struct bme680_field_data dados;
+    if (!bme680_aguardar_leitura_campos() ||
+        bme680_parse_field_data(leitor->campos, &dados, leitor->sensor) != BME680_OK ||
+        !(dados.status & BME680_NEW_DATA_MSK)) {
+        // Conversão perdida (ex.: falha de barramento): disparar outra
+        if (absolute_time_diff_us(leitor->pronto_em, get_absolute_time()) > leitor->periodo * 1000) {
+            leitor->reinicios++;
+            bme680_iniciar_conversao(leitor);
+        }
+        return false;
+    }
+
+    // Carimbo no meio da conversão que terminou, não na coleta (até um
+    // ciclo da aquisição depois); em seguida encadear a próxima
+    leitor->tempo_us = to_us_since_boot(leitor->pronto_em) - leitor->periodo * 500u;
+    bme680_iniciar_conversao(leitor);
+
+    leitor->conversoes++;
+    *pressao = dados.pressure / 100.0f;
+    *altitude = pressao_para_altitude(*pressao, pressao_base);
+    return true;
+}
+
+bool AERO_RAM_FUNC(bme680_coletar_altitude)(bme680_leitor_t *leitor, float pressao_base,
+                             float *pressao, float *altitude) {
+    return bme680_iniciar_coleta(leitor) &&
+           bme680_concluir_coleta(leitor, pressao_base, pressao, altitude);
+}
+
+void bme680_leitor_imprimir_estatisticas(const bme680_leitor_t *leitor) {
+    printf("BME|%u|%u|%u\n", leitor->conversoes, leitor->reinicios,
+           bme680_transacoes_barramento() - leitor->transacoes_inicio);
+}
+
+#ifdef AERO_BME680_BENCHMARK
+// Mede cada perfil com o leitor assíncrono, como na aquisição. O desvio
+// padrão da altitude (Welford) é calculado depois do descarte inicial,
+// para o filtro IIR assentar.
+void bme680_benchmark_perfis(struct bme680_dev *sensor, float pressao_base) {
+    bme680_perfil_t perfil_original = perfil_atual;
+    uint16_t periodo;
+
+    printf("BENCH|perfil|medicao_ms|taxa_hz|desvio_cm|amostras\n");
+    for (int i = 0; i < BME680_NUM_PERFIS; i++) {
+        if (!bme680_aplicar_perfil(sensor, (bme680_perfil_t)i, &periodo)) {
+            printf("BENCH|%s|erro\n", bme680_nome_perfil((bme680_perfil_t)i));
+            continue;
+        }
+
+        bme680_leitor_t leitor;
+        bme680_leitor_inicializar(&leitor, sensor, periodo);
+
+        uint32_t amostras = 0;
+        float media = 0.0f, m2 = 0.0f;
+        absolute_time_t inicio_medida = make_timeout_time_ms(BME680_BENCHMARK_DESCARTE_MS);
+        absolute_time_t fim = delayed_by_ms(inicio_medida, BME680_BENCHMARK_DURACAO_MS);
+
+        while (!time_reached(fim)) {
+            float pressao, altitude;
+            if (bme680_coletar_altitude(&leitor, pressao_base, &pressao, &altitude) &&
+                time_reached(inicio_medida)) {
+                amostras++;
+                float delta = altitude - media;
+                media += delta / amostras;
+                m2 += delta * (altitude - media);
+            }
+            sleep_us(200);
+        }
+
+        float taxa = amostras * 1000.0f / BME680_BENCHMARK_DURACAO_MS;
+        float desvio = amostras > 1 ? sqrtf(m2 / (amostras - 1)) : 0.0f;
+        printf("BENCH|%s|%u|%.1f|%.1f|%u\n", bme680_nome_perfil((bme680_perfil_t)i),
+               periodo, (double)taxa, (double)(desvio * 100.0f), amostras);
+    }
+
+    bme680_aplicar_perfil(sensor, perfil_original, &periodo);
+}
+#endif
@@ -3,6 +3,10 @@
 
 #include "bme680.h"
 #include "hardware/i2c.h"
+#include "barramento_i2c.h"
+#ifdef AERO_BME680_SPI
+#include "hardware/spi.h"
+#endif
 #include "pico/stdlib.h"
 
 // Configuração do I2C e sensor
@@ -10,23 +14,118 @@
 #define SCL_PIN_BME 5
 #define I2C_PORT_BME i2c0
 #define BME680_ADDR BME680_I2C_ADDR_SECONDARY
+#define BME680_TIMEOUT_US 3000  // Rajada de campos (15 bytes) leva ~400 us
+
+// Interface SPI (AERO_BME680_SPI), no lugar do i2c0
+#define BME680_SPI_PORT spi0
+#define BME680_SPI_MISO_PIN 4
+#define BME680_SPI_CS_PIN 5
+#define BME680_SPI_SCK_PIN 6
+#define BME680_SPI_MOSI_PIN 7
+#define BME680_SPI_BAUD (10 * 1000 * 1000)  // Máximo do BME680
+
+// Perfis de medição (oversampling de pressão/temperatura + filtro IIR)
+typedef enum {
+    BME680_PERFIL_BAIXA_LATENCIA,  // P 2x, T 1x, sem filtro
+    BME680_PERFIL_EQUILIBRADO,     // P 4x, T 1x, filtro 3
+    BME680_PERFIL_BAIXO_RUIDO,     // P 16x, T 2x, filtro 15
+    BME680_NUM_PERFIS
+} bme680_perfil_t;
+
+#ifndef BME680_PERFIL_PADRAO
+#define BME680_PERFIL_PADRAO BME680_PERFIL_EQUILIBRADO
+#endif
+
+// Benchmark dos perfis (AERO_BME680_BENCHMARK), com o sensor em repouso
+#define BME680_BENCHMARK_DESCARTE_MS 2000
+#define BME680_BENCHMARK_DURACAO_MS 10000
 
 // Parâmetros de calibração/filtro
 #define DEADZONE_METROS 0.2F
 #define NUM_CALIBRACAO 50
+#define NUM_VERIFICACAO_BARO 8  // Boot com calibração no flash
 #define ALPHA 0.2f
 
+#ifdef AERO_BME680_SPI
+typedef struct {
+    uint32_t transacoes;
+    uint32_t bytes;
+} bme680_spi_estatisticas_t;
+
+extern bme680_spi_estatisticas_t bme680_spi_stats;
+
+// Funções de interface SPI
+int8_t user_spi_write(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
+int8_t user_spi_read(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
+#else
+// Barramento do sensor (estatísticas de erro e latência)
+extern dispositivo_i2c_t bme680_i2c;
+
 // Funções de interface I2C
 int8_t user_i2c_write(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
 int8_t user_i2c_read(uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
+#endif
 void user_delay_ms(uint32_t period);
 
 // Funções de inicialização e calibração
 void bme680_inicializar(struct bme680_dev *sensor, uint16_t *periodo);
+
+// Troca o perfil com o sensor em sleep e atualiza a duração da medição.
+// Leitores em uso precisam ser reinicializados com o novo período.
+bool bme680_aplicar_perfil(struct bme680_dev *sensor, bme680_perfil_t perfil, uint16_t *periodo);
+const char *bme680_nome_perfil(bme680_perfil_t perfil);
 float calibrar_pressao(struct bme680_dev *sensor, uint16_t periodo);
 
+// Média de 'amostras' conversões forçadas (até JANELA_MAX_AMOSTRAS):
+// pressão em hPa e temperatura em °C. false sem nenhuma leitura válida.
+bool bme680_medir(struct bme680_dev *sensor, uint16_t periodo, uint8_t amostras,
+                  float *pressao, float *temperatura);
+
 // Função de leitura processada (pressão e altitude filtrada)
 bool bme680_ler_altitude(struct bme680_dev *sensor, uint16_t periodo,
                          float pressao_base, float *pressao, float *altitude);
 
+// Leitura assíncrona: a conversão forçada é disparada e coletada em um tick
+// posterior, sem esperar pelo sensor
+typedef struct {
+    struct bme680_dev *sensor;
+    uint16_t periodo;           // Duração da medição (ms), de bme680_get_profile_dur()
+    absolute_time_t pronto_em;  // Instante previsto para o fim da conversão
+    uint64_t tempo_us;          // Meio da conversão da última leitura coletada (time_us_64)
+    bool em_conversao;
+    bool coletando;             // Leitura dos campos por DMA em andamento
+    uint8_t campos[BME680_FIELD_LENGTH];
+    uint32_t conversoes;        // Leituras coletadas
+    uint32_t reinicios;         // Conversões que não terminaram no prazo
+    uint32_t transacoes_inicio; // Transações do barramento antes da primeira conversão
+} bme680_leitor_t;
+
+void bme680_leitor_inicializar(bme680_leitor_t *leitor, struct bme680_dev *sensor, uint16_t periodo);
+
+// Dispara uma conversão forçada e retorna imediatamente
+bool bme680_iniciar_conversao(bme680_leitor_t *leitor);
+
+// Coleta em duas fases, para sobrepor a leitura com outro barramento:
+// iniciar dispara a leitura dos campos se a conversão já terminou (por DMA
+// no I2C; no SPI a leitura é feita na hora);
+// concluir espera o DMA e retorna true se uma nova leitura foi coletada.
+// Nesse caso a próxima conversão já é disparada (medições encadeadas).
+bool bme680_iniciar_coleta(bme680_leitor_t *leitor);
+bool bme680_concluir_coleta(bme680_leitor_t *leitor, float pressao_base,
+                            float *pressao, float *altitude);
+
+// iniciar + concluir em sequência
+bool bme680_coletar_altitude(bme680_leitor_t *leitor, float pressao_base,
+                             float *pressao, float *altitude);
+
+// BME|conversoes|reinicios|transacoes: em regime são 2 transações por
+// amostra (disparo + rajada de status e campos)
+void bme680_leitor_imprimir_estatisticas(const bme680_leitor_t *leitor);
+
+#ifdef AERO_BME680_BENCHMARK
+// Para cada perfil: BENCH|perfil|medicao_ms|taxa_hz|desvio_cm|amostras.
+// Restaura o perfil ativo ao final.
+void bme680_benchmark_perfis(struct bme680_dev *sensor, float pressao_base);
+#endif
+
 #endif
@@ -158,6 +158,10 @@
 #define BME680_CONF_T_P_MODE_ADDR		UINT8_C(0x74)
 #define BME680_CONF_ODR_FILT_ADDR		UINT8_C(0x75)
 
+/** Shadowed configuration register window (0x70 to 0x75) */
+#define BME680_SHADOW_START_ADDR	BME680_CONF_HEAT_CTRL_ADDR
+#define BME680_SHADOW_LENGTH		UINT8_C(6)
+
 /** Coefficient's address */
 #define BME680_COEFF_ADDR1	UINT8_C(0x89)
 #define BME680_COEFF_ADDR2	UINT8_C(0xe1)
@@ -527,6 +531,10 @@ struct	bme680_dev {
 	bme680_delay_fptr_t delay_ms;
 	/*! Communication function result */
 	int8_t com_rslt;
+	/*! Shadow copy of the configuration registers, ctrl_meas kept in sleep mode */
+	uint8_t shadow_regs[BME680_SHADOW_LENGTH];
+	/*! Bit mask of the valid entries in shadow_regs */
+	uint8_t shadow_valid;
 };
 
 
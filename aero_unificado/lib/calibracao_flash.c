@@ -0,0 +1,79 @@
+#include "calibracao_flash.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+#define CALIBRACAO_OFFSET_FLASH (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+// Fim da imagem no flash, do linker script do SDK
+extern char __flash_binary_end;
+
+// O setor não é reservado no link: um binário que cresça até ele seria
+// lido como registro e, pior, apagado na gravação
+static bool setor_livre(void) {
+    uintptr_t fim = (uintptr_t)&__flash_binary_end - XIP_BASE;
+    if (fim > CALIBRACAO_OFFSET_FLASH) {
+        printf("ERRO: binário (%lu bytes) invade o setor da calibração em 0x%x\n",
+               (unsigned long)fim, (unsigned)CALIBRACAO_OFFSET_FLASH);
+        return false;
+    }
+    return true;
+}
+
+static uint32_t crc32(const void *dados, size_t tamanho) {
+    const uint8_t *p = dados;
+    uint32_t crc = 0xFFFFFFFFu;
+    while (tamanho--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+    }
+    return ~crc;
+}
+
+bool calibracao_carregar(calibracao_t *calibracao) {
+    if (!setor_livre()) return false;
+    const calibracao_t *gravada = (const calibracao_t *)(XIP_BASE + CALIBRACAO_OFFSET_FLASH);
+    memcpy(calibracao, gravada, sizeof(*calibracao));
+    return calibracao->magica == CALIBRACAO_MAGICA &&
+           calibracao->versao == CALIBRACAO_VERSAO &&
+           calibracao->tamanho == sizeof(calibracao_t) &&
+           calibracao->crc == crc32(calibracao, offsetof(calibracao_t, crc));
+}
+
+// Roda com as interrupções desligadas e o outro núcleo parado
+static void gravar_setor(void *param) {
+    flash_range_erase(CALIBRACAO_OFFSET_FLASH, FLASH_SECTOR_SIZE);
+    flash_range_program(CALIBRACAO_OFFSET_FLASH, param, FLASH_PAGE_SIZE);
+}
+
+bool calibracao_gravar(calibracao_t *calibracao) {
+    if (!setor_livre()) return false;
+    calibracao->magica = CALIBRACAO_MAGICA;
+    calibracao->versao = CALIBRACAO_VERSAO;
+    calibracao->tamanho = sizeof(calibracao_t);
+    calibracao->crc = crc32(calibracao, offsetof(calibracao_t, crc));
+
+    // Programação em páginas inteiras; o resto da página fica apagado
+    static uint8_t pagina[FLASH_PAGE_SIZE];
+    memset(pagina, 0xFF, sizeof(pagina));
+    memcpy(pagina, calibracao, sizeof(*calibracao));
+
+    int rc = flash_safe_execute(gravar_setor, pagina, 100);
+    if (rc != PICO_OK) {
+        printf("ERRO: gravação da calibração no flash falhou (%d)\n", rc);
+        return false;
+    }
+    return true;
+}
+
+bool calibracao_pedida(void) {
+    gpio_init(PINO_RECALIBRAR);
+    gpio_set_dir(PINO_RECALIBRAR, GPIO_IN);
+    gpio_pull_up(PINO_RECALIBRAR);
+    sleep_ms(1);  // Pull-up carregar a linha
+    bool pedida = !gpio_get(PINO_RECALIBRAR);
+    return pedida;
+}
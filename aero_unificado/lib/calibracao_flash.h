@@ -0,0 +1,41 @@
+#ifndef CALIBRACAO_FLASH_H
+#define CALIBRACAO_FLASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Registro de calibração no último setor do flash (4 KB; o linker não o
+// reserva, então carregar e gravar conferem que o binário termina antes
+// dele): biases da IMU e temperatura da calibração. No boot, o registro
+// válido evita os ~10 s de calibração da IMU; ele só é refeito a pedido
+// (botão no PINO_RECALIBRAR) ou quando a verificação rápida falha.
+#define CALIBRACAO_MAGICA 0x4F524541u  // "AERO"
+#define CALIBRACAO_VERSAO 2
+#define PINO_RECALIBRAR 20  // Ativo em nível baixo (botão para o GND) durante o boot
+
+// Limite da verificação rápida (além de mpu6500_verificar_calibracao).
+// A pressão não entra: muda com o tempo e o local, os biases da IMU não.
+#define CALIBRACAO_LIMITE_TEMPERATURA_C 10.0f  // Bias do giro muda com a temperatura
+
+typedef struct {
+    uint32_t magica;
+    uint16_t versao;
+    uint16_t tamanho;           // sizeof(calibracao_t)
+    float bias_giro[3];         // °/s
+    float erro_aceleracao[3];   // g
+    float temperatura;          // °C do BME680 na calibração
+    uint32_t crc;               // CRC-32 dos campos anteriores
+} calibracao_t;
+
+// Lê o registro do flash (XIP); false se ausente, de outra versão, com CRC
+// errado ou se o binário invade o setor
+bool calibracao_carregar(calibracao_t *calibracao);
+
+// Preenche cabeçalho e CRC e grava pelo flash_safe_execute (o outro núcleo,
+// se rodando, precisa ter chamado flash_safe_execute_core_init)
+bool calibracao_gravar(calibracao_t *calibracao);
+
+// Botão de recalibração pressionado no boot
+bool calibracao_pedida(void);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef CODIGO_RAM_H
+#define CODIGO_RAM_H
+
+// AERO_RAM_FUNC para os módulos que também compilam no host (testes e
+// benchmarks): no alvo vem de desempenho.h, no host não tem efeito
+#ifdef __arm__
+#include "desempenho.h"
+#else
+#define AERO_RAM_FUNC(nome) nome
+#endif
+
+#endif
@@ -0,0 +1,86 @@
+#include "decimador.h"
+#include <math.h>
+#include <string.h>
+#include "matematica_rapida.h"
+#include "codigo_ram.h"
+
+// Corte (-6 dB) em fração da taxa de entrada: meia transição abaixo de
+// taxa_saida / 2
+static float corte_para_taps(uint16_t taps, uint32_t taxa_entrada_hz, uint32_t taxa_saida_hz) {
+    return 0.5f * taxa_saida_hz / taxa_entrada_hz - 0.5f * DECIMADOR_TRANSICAO_HAMMING / taps;
+}
+
+uint16_t decimador_taps_minimos(uint32_t taxa_entrada_hz, uint32_t taxa_saida_hz) {
+    if (taxa_saida_hz == 0 || taxa_entrada_hz < taxa_saida_hz) return 0;
+    float fator = (float)taxa_entrada_hz / taxa_saida_hz;
+    float taps = 0.5f * DECIMADOR_TRANSICAO_HAMMING * fator / (0.5f - DECIMADOR_CORTE_MINIMO);
+    uint16_t multiplo = (uint16_t)ceilf(taps / 16.0f) * 16;
+    return multiplo <= DECIMADOR_MAX_TAPS ? multiplo : 0;
+}
+
+bool decimador_inicializar(decimador_t *d, uint8_t canais, uint16_t taps,
+                           uint32_t taxa_entrada_hz, uint32_t taxa_saida_hz) {
+    if (canais == 0 || canais > DECIMADOR_MAX_CANAIS) return false;
+    if (taps < 2 || taps > DECIMADOR_MAX_TAPS) return false;
+    if (taxa_saida_hz == 0 || taxa_entrada_hz % taxa_saida_hz != 0) return false;
+
+    float corte = corte_para_taps(taps, taxa_entrada_hz, taxa_saida_hz);  // Fração da taxa de entrada
+    if (corte * taxa_entrada_hz < DECIMADOR_CORTE_MINIMO * taxa_saida_hz) return false;
+
+    memset(d, 0, sizeof(*d));
+    d->canais = canais;
+    d->taps = taps;
+    d->fator = taxa_entrada_hz / taxa_saida_hz;
+
+    // Projeto só na inicialização: sinf/cosf da libm bastam
+    float centro = (taps - 1) * 0.5f;
+    float soma = 0.0f;
+    for (int k = 0; k < taps; k++) {
+        float x = k - centro;
+        float sinc = (x == 0.0f) ? 2.0f * corte
+                                 : sinf(2.0f * MAT_PI * corte * x) / (MAT_PI * x);
+        float janela = 0.54f - 0.46f * cosf(2.0f * MAT_PI * k / (taps - 1));
+        d->coeficientes[k] = sinc * janela;
+        soma += d->coeficientes[k];
+    }
+    // Ganho unitário em DC: g e graus passam sem erro de escala
+    for (int k = 0; k < taps; k++) d->coeficientes[k] /= soma;
+
+    // Histórico ainda vazio (ver decimador_adicionar)
+    d->fase = UINT16_MAX;
+    return true;
+}
+
+bool AERO_RAM_FUNC(decimador_adicionar)(decimador_t *d, const float *entrada, float *saida) {
+    uint16_t taps = d->taps;
+
+    if (d->fase == UINT16_MAX) {
+        // Primeira amostra: preenche o anel com ela em vez de zeros, para
+        // a saída não partir de 0 g / 0 graus
+        for (int c = 0; c < d->canais; c++) {
+            for (int k = 0; k < 2 * taps; k++) d->historico[c][k] = entrada[c];
+        }
+        d->fase = 0;
+    }
+
+    uint16_t p = d->posicao;
+    for (int c = 0; c < d->canais; c++) {
+        d->historico[c][p] = entrada[c];
+        d->historico[c][p + taps] = entrada[c];
+    }
+    d->posicao = (p + 1 == taps) ? 0 : p + 1;
+
+    if (++d->fase < d->fator) return false;
+    d->fase = 0;
+
+    // Só a fase que sai é calculada: taps * canais MACs a cada 'fator'
+    // entradas. Janela do mais antigo ([posicao]) ao mais novo.
+    const float *h = d->coeficientes;
+    for (int c = 0; c < d->canais; c++) {
+        const float *x = &d->historico[c][d->posicao];
+        float acc = 0.0f;
+        for (int k = 0; k < taps; k++) acc += h[k] * x[k];
+        saida[c] = acc;
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef DECIMADOR_H
+#define DECIMADOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Decimação FIR anti-aliasing: passa-baixas de fase linear (sinc com janela
+// de Hamming) aplicado por anel de amostras, com uma saída a cada 'fator'
+// entradas. Sem alocação: coeficientes e históricos ficam na própria
+// estrutura.
+//
+// A transição da janela de Hamming tem ~3.3 * taxa_entrada / taps; o corte
+// (-6 dB) fica meia transição abaixo de taxa_saida / 2, para a rejeição
+// (>= 42 dB) começar na frequência que dobraria sobre a banda de saída.
+// Com poucos taps o corte cai demais e a inicialização recusa.
+//
+// decimador_taps_minimos dá o menor comprimento (múltiplo de 16) com corte
+// em pelo menos 0.25 * taxa de saída. Para 50 Hz de saída: 16 taps a
+// 100 Hz, 80 a 500 Hz e 144 a 1 kHz, com corte em 13.5..14.7 Hz,
+// -1.5..-2.5 dB em 10 Hz e atraso de grupo ((taps - 1) / 2 amostras de
+// entrada) de 72..79 ms.
+#define DECIMADOR_MAX_TAPS 160
+#define DECIMADOR_MAX_CANAIS 6
+#define DECIMADOR_TRANSICAO_HAMMING 3.3f  // Largura da transição * taps / taxa_entrada
+#define DECIMADOR_CORTE_MINIMO 0.25f      // Fração da taxa de saída
+
+// 0: decimador_taps_minimos para as taxas em uso
+#ifndef DECIMADOR_TAPS
+#define DECIMADOR_TAPS 0
+#endif
+
+typedef struct {
+    float coeficientes[DECIMADOR_MAX_TAPS];
+    // Cada amostra é escrita em [i] e [i + taps]: a janela dos últimos
+    // 'taps' valores fica sempre contígua, sem teste de volta no produto
+    float historico[DECIMADOR_MAX_CANAIS][2 * DECIMADOR_MAX_TAPS];
+    uint16_t taps;
+    uint16_t fator;
+    uint16_t posicao;  // Próxima escrita no anel
+    uint16_t fase;     // Entradas desde a última saída
+    uint8_t canais;
+} decimador_t;
+
+// Projeta o filtro para taxa_entrada_hz -> taxa_saida_hz (múltiplo inteiro)
+// e zera o histórico. Retorna false se os parâmetros não couberem ou se os
+// taps não bastam para o corte mínimo.
+bool decimador_inicializar(decimador_t *d, uint8_t canais, uint16_t taps,
+                           uint32_t taxa_entrada_hz, uint32_t taxa_saida_hz);
+
+// Menor número de taps para o corte mínimo (0 se passa de DECIMADOR_MAX_TAPS)
+uint16_t decimador_taps_minimos(uint32_t taxa_entrada_hz, uint32_t taxa_saida_hz);
+
+// Insere uma amostra de cada canal. Retorna true quando completou um
+// período de saída, com o valor filtrado de cada canal em 'saida'.
+bool decimador_adicionar(decimador_t *d, const float *entrada, float *saida);
+
+#endif
@@ -0,0 +1,73 @@
+// Teste do decimador: ganho em DC, atenuação de tons acima de
+// taxa_saida / 2 (que dobrariam sobre a banda de saída) e perda na banda,
+// medidos na saída decimada para as taxas da IMU (100 Hz, FIFO a 500 Hz
+// no I2C e a 1 kHz no SPI) com os taps de decimador_taps_minimos.
+//
+// No host:
+//   gcc -O2 -Ilib/teste_host -Ilib lib/decimador_teste.c lib/decimador.c -lm
+#include <math.h>
+#include "teste.h"
+#include "decimador.h"
+
+#define TAXA_SAIDA_HZ 50
+#define SAIDAS_MEDIDAS 400
+
+static decimador_t decimador;
+
+// Amplitude de pico da saída para um seno de amplitude 1 em 'freq_hz',
+// depois do atraso do filtro
+static double amplitude_saida(uint32_t taxa_entrada_hz, double freq_hz) {
+    uint16_t fator = taxa_entrada_hz / TAXA_SAIDA_HZ;
+    int descarte = decimador.taps / fator + 1;
+    double soma_quadrados = 0.0;
+    int saidas = 0;
+    for (long n = 0; saidas < descarte + SAIDAS_MEDIDAS; n++) {
+        float entrada = (float)sin(2.0 * M_PI * freq_hz * n / taxa_entrada_hz + 0.3);
+        float saida;
+        if (decimador_adicionar(&decimador, &entrada, &saida)) {
+            if (saidas++ >= descarte) soma_quadrados += (double)saida * saida;
+        }
+    }
+    return sqrt(2.0 * soma_quadrados / SAIDAS_MEDIDAS);
+}
+
+static double db(double amplitude) {
+    return 20.0 * log10(amplitude);
+}
+
+static void testar_taxa(uint32_t taxa_entrada_hz, uint16_t taps_esperados) {
+    uint16_t taps = decimador_taps_minimos(taxa_entrada_hz, TAXA_SAIDA_HZ);
+    VERIFICAR(taps == taps_esperados);
+    VERIFICAR(decimador_inicializar(&decimador, 1, taps, taxa_entrada_hz, TAXA_SAIDA_HZ));
+
+    float um = 1.0f, saida = 0.0f;
+    for (int n = 0; n < 2 * taps; n++) decimador_adicionar(&decimador, &um, &saida);
+    VERIFICAR_PROXIMO(saida, 1.0, 1e-5);
+
+    // Banda de saída: até 5 Hz praticamente intacta, 10 Hz perto do corte
+    VERIFICAR(decimador_inicializar(&decimador, 1, taps, taxa_entrada_hz, TAXA_SAIDA_HZ));
+    VERIFICAR(db(amplitude_saida(taxa_entrada_hz, 5.0)) > -0.5);
+    VERIFICAR(decimador_inicializar(&decimador, 1, taps, taxa_entrada_hz, TAXA_SAIDA_HZ));
+    VERIFICAR(db(amplitude_saida(taxa_entrada_hz, 10.0)) > -3.0);
+
+    // Rejeição a partir de taxa_saida / 2
+    const double tons[] = { 25.0, 30.0, 40.0, 47.0 };
+    for (unsigned i = 0; i < sizeof(tons) / sizeof(tons[0]); i++) {
+        if (tons[i] >= taxa_entrada_hz / 2.0) continue;
+        VERIFICAR(decimador_inicializar(&decimador, 1, taps, taxa_entrada_hz, TAXA_SAIDA_HZ));
+        double atenuacao = db(amplitude_saida(taxa_entrada_hz, tons[i]));
+        printf("DEC|%u|%u|%.0f|%.1f\n", (unsigned)taxa_entrada_hz, taps, tons[i], atenuacao);
+        VERIFICAR(atenuacao < -40.0);
+    }
+
+    // Menos taps deixam o corte abaixo do mínimo
+    VERIFICAR(!decimador_inicializar(&decimador, 1, taps - 16, taxa_entrada_hz, TAXA_SAIDA_HZ));
+}
+
+int main(void) {
+    testar_taxa(100, 16);
+    testar_taxa(500, 80);
+    testar_taxa(1000, 144);
+    VERIFICAR(decimador_taps_minimos(2000, TAXA_SAIDA_HZ) == 0);  // Passaria de DECIMADOR_MAX_TAPS
+    return teste_resultado("decimador");
+}
@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include "desempenho.h"
+#include "hardware/structs/xip_ctrl.h"
+
+void desempenho_inicializar_nucleo(void) {
+    m33_hw->demcr |= M33_DEMCR_TRCENA_BITS;
+    m33_hw->dwt_cyccnt = 0;
+    m33_hw->dwt_ctrl |= M33_DWT_CTRL_CYCCNTENA_BITS;
+}
+
+void AERO_RAM_FUNC(medidor_registrar)(medidor_ciclos_t *m, uint32_t inicio) {
+    uint32_t ciclos = desempenho_ciclos() - inicio;
+    m->execucoes++;
+    m->ciclos_total += ciclos;
+    if (ciclos < m->ciclos_min) m->ciclos_min = ciclos;
+    if (ciclos > m->ciclos_max) m->ciclos_max = ciclos;
+}
+
+void medidor_imprimir(const medidor_ciclos_t *m) {
+    uint32_t medio = m->execucoes ? (uint32_t)(m->ciclos_total / m->execucoes) : 0;
+    printf("PERF|%s|%u|%u|%u|%u\n", m->nome, m->execucoes,
+           m->execucoes ? m->ciclos_min : 0, medio, m->ciclos_max);
+}
+
+void desempenho_imprimir_xip(void) {
+    uint32_t acessos = xip_ctrl_hw->ctr_acc;
+    uint32_t acertos = xip_ctrl_hw->ctr_hit;
+
+    // Escrever qualquer valor zera o contador
+    xip_ctrl_hw->ctr_acc = 0;
+    xip_ctrl_hw->ctr_hit = 0;
+
+    uint32_t por_mil = acessos ? (uint32_t)((uint64_t)acertos * 1000 / acessos) : 0;
+    printf("XIP|%u|%u|%u\n", acessos, acertos, por_mil);
+}
@@ -0,0 +1,44 @@
+#ifndef DESEMPENHO_H
+#define DESEMPENHO_H
+
+#include "pico/stdlib.h"
+#include "hardware/structs/m33.h"
+
+// Funções do caminho de cada amostra. Com AERO_CODIGO_RAM são copiadas
+// para a SRAM no boot (seção .time_critical) e não disputam a cache do
+// XIP; sem a opção continuam no flash, para comparar as duas versões.
+#ifdef AERO_CODIGO_RAM
+#define AERO_RAM_FUNC(nome) __not_in_flash_func(nome)
+#else
+#define AERO_RAM_FUNC(nome) nome
+#endif
+
+// Tempo de execução de um trecho em ciclos de clock (contador DWT do núcleo)
+typedef struct {
+    const char *nome;
+    uint32_t execucoes;
+    uint32_t ciclos_min;
+    uint32_t ciclos_max;
+    uint64_t ciclos_total;
+} medidor_ciclos_t;
+
+#define MEDIDOR_CICLOS(n) { .nome = (n), .ciclos_min = UINT32_MAX }
+
+// Habilita o contador de ciclos do núcleo que chamar (um por núcleo)
+void desempenho_inicializar_nucleo(void);
+
+static inline uint32_t desempenho_ciclos(void) {
+    return m33_hw->dwt_cyccnt;
+}
+
+// Registra o trecho iniciado em 'inicio' (valor de desempenho_ciclos())
+void medidor_registrar(medidor_ciclos_t *m, uint32_t inicio);
+
+// PERF|nome|execucoes|ciclos_min|ciclos_medio|ciclos_max
+void medidor_imprimir(const medidor_ciclos_t *m);
+
+// XIP|acessos|acertos|acertos_por_mil desde a chamada anterior (os
+// contadores da cache são zerados a cada impressão)
+void desempenho_imprimir_xip(void);
+
+#endif
@@ -0,0 +1,75 @@
+#include "fluxo_amostras.h"
+#include "codigo_ram.h"
+
+void AERO_RAM_FUNC(fluxo_publicar)(fluxo_t *fluxo, uint64_t tempo_us, const float *valores) {
+    amostra_tempo_t amostra = { .tempo_us = tempo_us };
+    memcpy(amostra.valores, valores, fluxo->num_valores * sizeof(float));
+    seqlock_publicar(&fluxo->lock, &fluxo->amostras[fluxo->proxima], &amostra, sizeof(amostra));
+    fluxo->proxima = (fluxo->proxima + 1) % FLUXO_PROFUNDIDADE;
+    fluxo->publicadas++;
+}
+
+static float diferenca_angular(float de, float para) {
+    float d = para - de;
+    if (d >= 180.0f) d -= 360.0f;
+    else if (d < -180.0f) d += 360.0f;
+    return d;
+}
+
+bool fluxo_alinhar(const fluxo_t *fluxo, uint64_t tempo_us, float *valores, uint32_t *idade_us) {
+    amostra_tempo_t copia[FLUXO_PROFUNDIDADE];
+    seqlock_ler(&fluxo->lock, copia, fluxo->amostras, sizeof(copia));
+
+    // Vizinhas do instante pedido: a última até ele e a primeira depois
+    const amostra_tempo_t *antes = NULL, *depois = NULL;
+    for (int i = 0; i < FLUXO_PROFUNDIDADE; i++) {
+        const amostra_tempo_t *a = &copia[i];
+        if (a->tempo_us == 0) continue;
+        if (a->tempo_us <= tempo_us) {
+            if (!antes || a->tempo_us > antes->tempo_us) antes = a;
+        } else if (!depois || a->tempo_us < depois->tempo_us) {
+            depois = a;
+        }
+    }
+    if (!antes && !depois) return false;
+
+    if (!antes) {
+        // Instante anterior a todo o histórico: a amostra mais antiga
+        memcpy(valores, depois->valores, fluxo->num_valores * sizeof(float));
+        *idade_us = 0;
+        return true;
+    }
+    if (!fluxo->interpolar || !depois) {
+        memcpy(valores, antes->valores, fluxo->num_valores * sizeof(float));
+        *idade_us = (uint32_t)(tempo_us - antes->tempo_us);
+        return true;
+    }
+
+    float peso = (float)(tempo_us - antes->tempo_us) / (float)(depois->tempo_us - antes->tempo_us);
+    for (int i = 0; i < fluxo->num_valores; i++) {
+        float a = antes->valores[i], b = depois->valores[i];
+        if (fluxo->angulares & (1u << i)) {
+            float v = a + diferenca_angular(a, b) * peso;
+            valores[i] = v > 180.0f ? v - 360.0f : v <= -180.0f ? v + 360.0f : v;
+        } else {
+            valores[i] = a + (b - a) * peso;
+        }
+    }
+    *idade_us = 0;
+    return true;
+}
+
+bool fluxo_mais_recente(const fluxo_t *fluxo, amostra_tempo_t *amostra) {
+    amostra_tempo_t copia[FLUXO_PROFUNDIDADE];
+    seqlock_ler(&fluxo->lock, copia, fluxo->amostras, sizeof(copia));
+
+    const amostra_tempo_t *recente = NULL;
+    for (int i = 0; i < FLUXO_PROFUNDIDADE; i++) {
+        if (copia[i].tempo_us != 0 && (!recente || copia[i].tempo_us > recente->tempo_us)) {
+            recente = &copia[i];
+        }
+    }
+    if (!recente) return false;
+    *amostra = *recente;
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef FLUXO_AMOSTRAS_H
+#define FLUXO_AMOSTRAS_H
+
+#include "pico/stdlib.h"
+#include "seqlock.h"
+
+// Barramento de amostras com carimbo de tempo: cada sensor publica num
+// fluxo as suas leituras com o instante de aquisição (time_us_64), e o
+// consumidor lê o valor de cada fluxo num instante comum, interpolado
+// entre as amostras vizinhas ou retido da última, junto com a idade.
+// Um produtor por fluxo; leitores em qualquer núcleo (seqlock).
+#define FLUXO_MAX_VALORES 6
+#define FLUXO_PROFUNDIDADE 16  // Amostras por fluxo: cobre o atraso de alinhamento a 100 Hz
+
+typedef struct {
+    uint64_t tempo_us;  // 0 = posição ainda vazia
+    float valores[FLUXO_MAX_VALORES];
+} amostra_tempo_t;
+
+typedef struct {
+    const char *nome;
+    uint8_t num_valores;
+    bool interpolar;      // false: retém a última amostra (medidas esparsas, ex.: GPS)
+    uint32_t angulares;   // Bit i: valor i em graus, interpolado pelo menor arco
+
+    seqlock_t lock;
+    amostra_tempo_t amostras[FLUXO_PROFUNDIDADE];
+    uint8_t proxima;      // Só o produtor escreve
+    uint32_t publicadas;
+} fluxo_t;
+
+#define FLUXO(n, valores, interp, ang) \
+    { .nome = (n), .num_valores = (valores), .interpolar = (interp), .angulares = (ang) }
+
+void fluxo_publicar(fluxo_t *fluxo, uint64_t tempo_us, const float *valores);
+
+// Valores no instante tempo_us. idade_us é a distância até a amostra retida
+// (0 quando interpolado). Retorna false se o fluxo ainda não tem amostras.
+bool fluxo_alinhar(const fluxo_t *fluxo, uint64_t tempo_us, float *valores, uint32_t *idade_us);
+
+// Amostra mais recente; retorna false se o fluxo está vazio
+bool fluxo_mais_recente(const fluxo_t *fluxo, amostra_tempo_t *amostra);
+
+#endif
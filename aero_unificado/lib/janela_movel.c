@@ -0,0 +1,89 @@
+#include "janela_movel.h"
+#include <string.h>
+#include "matematica_rapida.h"
+#include "codigo_ram.h"
+
+bool janela_inicializar(janela_movel_t *janela, uint8_t eixos, uint8_t tamanho) {
+    if (eixos == 0 || eixos > JANELA_MAX_EIXOS || tamanho == 0 || tamanho > JANELA_MAX_AMOSTRAS) {
+        return false;
+    }
+    memset(janela, 0, sizeof(*janela));
+    janela->eixos = eixos;
+    janela->tamanho = tamanho;
+    return true;
+}
+
+// A cada volta: referência na amostra mais nova (acompanha sinais que
+// derivam) e somas exatas do buffer
+static void recalcular_somas(janela_movel_t *janela) {
+    for (int e = 0; e < janela->eixos; e++) {
+        janela->referencia[e] = janela->amostras[e][janela->contagem - 1];
+        float soma = 0.0f, soma_quadrados = 0.0f;
+        for (int i = 0; i < janela->contagem; i++) {
+            float d = janela->amostras[e][i] - janela->referencia[e];
+            soma += d;
+            soma_quadrados += d * d;
+        }
+        janela->soma[e] = soma;
+        janela->soma_quadrados[e] = soma_quadrados;
+    }
+}
+
+void AERO_RAM_FUNC(janela_adicionar)(janela_movel_t *janela, const float *valores) {
+    if (janela->contagem == 0) {
+        for (int e = 0; e < janela->eixos; e++) janela->referencia[e] = valores[e];
+    }
+
+    uint8_t i = janela->indice;
+    bool cheia = janela_cheia(janela);
+    for (int e = 0; e < janela->eixos; e++) {
+        float ref = janela->referencia[e];
+        float novo = valores[e] - ref;
+        janela->soma[e] += novo;
+        janela->soma_quadrados[e] += novo * novo;
+        if (cheia) {
+            float velho = janela->amostras[e][i] - ref;
+            janela->soma[e] -= velho;
+            janela->soma_quadrados[e] -= velho * velho;
+        }
+        janela->amostras[e][i] = valores[e];
+    }
+
+    if (!cheia) janela->contagem++;
+    janela->indice = (i + 1 == janela->tamanho) ? 0 : i + 1;
+    if (janela->indice == 0) recalcular_somas(janela);
+}
+
+float janela_media(const janela_movel_t *janela, uint8_t eixo) {
+    if (janela->contagem == 0) return 0.0f;
+    return janela->referencia[eixo] + janela->soma[eixo] / janela->contagem;
+}
+
+float janela_variancia(const janela_movel_t *janela, uint8_t eixo) {
+    uint8_t n = janela->contagem;
+    if (n < 2) return 0.0f;
+    float soma = janela->soma[eixo];
+    float variancia = (janela->soma_quadrados[eixo] - soma * soma / n) / (n - 1);
+    return variancia > 0.0f ? variancia : 0.0f;
+}
+
+float janela_desvio(const janela_movel_t *janela, uint8_t eixo) {
+    return mat_sqrt(janela_variancia(janela, eixo));
+}
+
+float janela_mediana(const janela_movel_t *janela, uint8_t eixo) {
+    uint8_t n = janela->contagem;
+    if (n == 0) return 0.0f;
+
+    float ordenadas[JANELA_MAX_AMOSTRAS];
+    for (int i = 0; i < n; i++) {
+        float v = janela->amostras[eixo][i];
+        int j = i;
+        while (j > 0 && ordenadas[j - 1] > v) {
+            ordenadas[j] = ordenadas[j - 1];
+            j--;
+        }
+        ordenadas[j] = v;
+    }
+    return (n & 1) ? ordenadas[n / 2] : 0.5f * (ordenadas[n / 2 - 1] + ordenadas[n / 2]);
+}
@@ -0,0 +1,48 @@
+#ifndef JANELA_MOVEL_H
+#define JANELA_MOVEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Janela móvel de tamanho fixo com até 3 eixos: média e variância em O(1)
+// por amostra pelas somas correntes, mediana sob demanda. As amostras de
+// cada eixo ficam contíguas (estrutura de arrays).
+//
+// As somas são relativas a uma amostra de referência (sem cancelamento em
+// float para valores longe de zero, ex.: altitude MSL) e recalculadas do
+// buffer a cada volta completa, para o erro de arredondamento não acumular.
+#define JANELA_MAX_EIXOS 3
+#define JANELA_MAX_AMOSTRAS 64
+
+typedef struct {
+    uint8_t eixos;
+    uint8_t tamanho;
+    uint8_t indice;     // Próxima posição a sobrescrever
+    uint8_t contagem;
+    float amostras[JANELA_MAX_EIXOS][JANELA_MAX_AMOSTRAS];
+    float referencia[JANELA_MAX_EIXOS];
+    float soma[JANELA_MAX_EIXOS];            // De (x - referencia)
+    float soma_quadrados[JANELA_MAX_EIXOS];  // De (x - referencia)²
+} janela_movel_t;
+
+// Retorna false se eixos ou tamanho excedem os máximos
+bool janela_inicializar(janela_movel_t *janela, uint8_t eixos, uint8_t tamanho);
+
+// Uma amostra com um valor por eixo; a mais antiga sai quando a janela está cheia
+void janela_adicionar(janela_movel_t *janela, const float *valores);
+
+static inline bool janela_cheia(const janela_movel_t *janela) {
+    return janela->contagem == janela->tamanho;
+}
+
+// 0 com a janela vazia
+float janela_media(const janela_movel_t *janela, uint8_t eixo);
+
+// Variância amostral (n - 1); 0 com menos de 2 amostras
+float janela_variancia(const janela_movel_t *janela, uint8_t eixo);
+float janela_desvio(const janela_movel_t *janela, uint8_t eixo);
+
+// O(n²) sobre uma cópia (inserção; n <= JANELA_MAX_AMOSTRAS); fora do laço rápido
+float janela_mediana(const janela_movel_t *janela, uint8_t eixo);
+
+#endif
@@ -0,0 +1,96 @@
+// Teste da janela móvel contra a força bruta em double sobre as últimas n
+// amostras: média, variância e mediana a cada amostra, com a janela
+// enchendo, dando milhares de voltas (somas recalculadas a cada uma) e
+// com eixos longe de zero (pressão em hPa com ruído de 0,01 hPa, altitude
+// MSL que deriva ao longo de 1500 m).
+//
+// No host:
+//   gcc -O2 -Ilib/teste_host -Ilib lib/janela_movel_teste.c lib/janela_movel.c lib/matematica_rapida.c -lm
+#include <math.h>
+#include "teste.h"
+#include "janela_movel.h"
+
+#define AMOSTRAS 100000
+
+static float historico[AMOSTRAS][JANELA_MAX_EIXOS];
+
+// LCG: a mesma sequência em qualquer host; uniforme em [-1, 1)
+static uint32_t semente = 2;
+
+static float ruido(void) {
+    semente = semente * 1664525u + 1013904223u;
+    return (semente >> 8) / 8388608.0f - 1.0f;
+}
+
+static float mediana_referencia(int k, int n, int eixo) {
+    float ordenadas[JANELA_MAX_AMOSTRAS];
+    for (int i = 0; i < n; i++) ordenadas[i] = historico[k - n + 1 + i][eixo];
+    for (int a = 1; a < n; a++) {
+        for (int b = a; b > 0 && ordenadas[b - 1] > ordenadas[b]; b--) {
+            float t = ordenadas[b];
+            ordenadas[b] = ordenadas[b - 1];
+            ordenadas[b - 1] = t;
+        }
+    }
+    return (n & 1) ? ordenadas[n / 2] : 0.5f * (ordenadas[n / 2 - 1] + ordenadas[n / 2]);
+}
+
+static void testar_tamanho(uint8_t tamanho) {
+    janela_movel_t janela;
+    VERIFICAR(janela_inicializar(&janela, 3, tamanho));
+    VERIFICAR(janela_media(&janela, 0) == 0.0f);
+    VERIFICAR(janela_variancia(&janela, 0) == 0.0f);
+    VERIFICAR(janela_mediana(&janela, 0) == 0.0f);
+
+    double erro_media[3] = { 0 }, erro_variancia[3] = { 0 };
+    for (int k = 0; k < AMOSTRAS; k++) {
+        float *v = historico[k];
+        v[0] = 1013.25f + 0.01f * ruido();
+        v[1] = 800.0f + 0.015f * k + 0.5f * ruido();
+        v[2] = 3.0f * ruido();
+        janela_adicionar(&janela, v);
+
+        int n = k + 1 < tamanho ? k + 1 : tamanho;
+        VERIFICAR(janela.contagem == n);
+        VERIFICAR(janela_cheia(&janela) == (n == tamanho));
+        for (int e = 0; e < 3; e++) {
+            double media = 0.0, quadrados = 0.0;
+            for (int i = k - n + 1; i <= k; i++) media += historico[i][e];
+            media /= n;
+            for (int i = k - n + 1; i <= k; i++) {
+                quadrados += (historico[i][e] - media) * (historico[i][e] - media);
+            }
+            double variancia = n > 1 ? quadrados / (n - 1) : 0.0;
+
+            // Erros relativos à escala do eixo (nível mais espalhamento) e
+            // à própria variância
+            double escala = fabs(media) + sqrt(variancia) + 1e-3;
+            double em = fabs(janela_media(&janela, e) - media) / escala;
+            double ev = fabs(janela_variancia(&janela, e) - variancia) / (variancia > 1e-6 ? variancia : 1e-6);
+            if (em > erro_media[e]) erro_media[e] = em;
+            if (ev > erro_variancia[e]) erro_variancia[e] = ev;
+
+            VERIFICAR(janela_mediana(&janela, e) == mediana_referencia(k, n, e));
+        }
+    }
+
+    for (int e = 0; e < 3; e++) {
+        printf("JAN|%u|eixo %d|media %.2e|variancia %.2e\n", tamanho, e, erro_media[e], erro_variancia[e]);
+        VERIFICAR(erro_media[e] < 1e-5);
+        VERIFICAR(erro_variancia[e] < 1e-4);
+    }
+    VERIFICAR_PROXIMO(janela_desvio(&janela, 1), sqrt(janela_variancia(&janela, 1)), 1e-3);
+}
+
+int main(void) {
+    janela_movel_t janela;
+    VERIFICAR(!janela_inicializar(&janela, 0, 5));
+    VERIFICAR(!janela_inicializar(&janela, JANELA_MAX_EIXOS + 1, 5));
+    VERIFICAR(!janela_inicializar(&janela, 1, 0));
+    VERIFICAR(!janela_inicializar(&janela, 1, JANELA_MAX_AMOSTRAS + 1));
+
+    testar_tamanho(5);
+    testar_tamanho(8);
+    testar_tamanho(JANELA_MAX_AMOSTRAS);
+    return teste_resultado("janela_movel");
+}
@@ -0,0 +1,95 @@
+#include "kalman_vertical.h"
+#include <stdio.h>
+#include <string.h>
+#include "codigo_ram.h"
+
+static void reiniciar_covariancia(kalman_vertical_t *kv) {
+    memset(kv->P, 0, sizeof(kv->P));
+    kv->P[0][0] = KV_RUIDO_BARO * KV_RUIDO_BARO;
+    kv->P[1][1] = 1.0f;
+    kv->P[2][2] = 0.1f;
+}
+
+void kalman_vertical_inicializar(kalman_vertical_t *kv) {
+    memset(kv, 0, sizeof(*kv));
+    reiniciar_covariancia(kv);
+}
+
+void AERO_RAM_FUNC(kalman_vertical_propagar)(kalman_vertical_t *kv, float aceleracao_vertical, float dt) {
+    float *x = kv->x;
+    float a = aceleracao_vertical - x[2];
+    x[0] += x[1] * dt + 0.5f * a * dt * dt;
+    x[1] += a * dt;
+
+    // P = F P F' + Q, com F = [1 dt -dt²/2; 0 1 -dt; 0 0 1]
+    float (*P)[3] = kv->P;
+    float m = -0.5f * dt * dt;
+    float FP[3][3];
+    for (int j = 0; j < 3; j++) {
+        FP[0][j] = P[0][j] + dt * P[1][j] + m * P[2][j];
+        FP[1][j] = P[1][j] - dt * P[2][j];
+        FP[2][j] = P[2][j];
+    }
+    for (int i = 0; i < 3; i++) {
+        P[i][0] = FP[i][0] + dt * FP[i][1] + m * FP[i][2];
+        P[i][1] = FP[i][1] - dt * FP[i][2];
+        P[i][2] = FP[i][2];
+    }
+
+    // Ruído branco de aceleração integrado duas vezes + passeio do bias
+    float qa = KV_RUIDO_ACEL * KV_RUIDO_ACEL;
+    float dt2 = dt * dt;
+    P[0][0] += qa * dt2 * dt * (1.0f / 3.0f);
+    P[0][1] += qa * dt2 * 0.5f;
+    P[1][0] += qa * dt2 * 0.5f;
+    P[1][1] += qa * dt;
+    P[2][2] += KV_RUIDO_BIAS * KV_RUIDO_BIAS * dt;
+}
+
+// Medida escalar da altitude (H = [1 0 0]) com porta de inovação
+static bool corrigir_altitude(kalman_vertical_t *kv, float z, float variancia) {
+    float (*P)[3] = kv->P;
+    float inovacao = z - kv->x[0];
+    float S = P[0][0] + variancia;
+    if (inovacao * inovacao > KV_PORTA_SIGMAS * KV_PORTA_SIGMAS * S) {
+        kv->rejeicoes++;
+        return false;
+    }
+
+    float K[3] = { P[0][0] / S, P[1][0] / S, P[2][0] / S };
+    float linha0[3] = { P[0][0], P[0][1], P[0][2] };
+    for (int i = 0; i < 3; i++) {
+        kv->x[i] += K[i] * inovacao;
+        for (int j = 0; j < 3; j++) P[i][j] -= K[i] * linha0[j];
+    }
+    return true;
+}
+
+void kalman_vertical_corrigir_baro(kalman_vertical_t *kv, float altitude) {
+    if (!kv->inicializado) {
+        kv->x[0] = altitude;
+        kv->x[1] = 0.0f;
+        kv->x[2] = 0.0f;
+        reiniciar_covariancia(kv);
+        kv->inicializado = true;
+        return;
+    }
+    if (corrigir_altitude(kv, altitude, KV_RUIDO_BARO * KV_RUIDO_BARO)) kv->correcoes_baro++;
+}
+
+void kalman_vertical_corrigir_gps(kalman_vertical_t *kv, float altitude_msl) {
+    if (!kv->inicializado) return;
+    if (!kv->gps_referenciado) {
+        kv->referencia_gps = altitude_msl - kv->x[0];
+        kv->gps_referenciado = true;
+        return;
+    }
+    if (corrigir_altitude(kv, altitude_msl - kv->referencia_gps, KV_RUIDO_GPS * KV_RUIDO_GPS)) {
+        kv->correcoes_gps++;
+    }
+}
+
+void kalman_vertical_imprimir_estatisticas(const kalman_vertical_t *kv) {
+    printf("VERT|%lu|%lu|%lu|%.3f\n", (unsigned long)kv->correcoes_baro,
+           (unsigned long)kv->correcoes_gps, (unsigned long)kv->rejeicoes, (double)kv->x[2]);
+}
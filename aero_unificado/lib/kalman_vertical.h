@@ -0,0 +1,50 @@
+#ifndef KALMAN_VERTICAL_H
+#define KALMAN_VERTICAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Canal vertical: Kalman de 3 estados (altitude, velocidade vertical e
+// bias do acelerômetro) propagado na taxa da IMU com a aceleração vertical
+// no referencial da Terra e corrigido pelo barômetro e pela altitude do
+// GGA. Tamanho fixo, sem alocação; a propagação custa ~60 operações em
+// float por amostra.
+//
+// A altitude segue o referencial do barômetro (0 na pressão base). O GPS
+// (MSL) é amarrado a ele na primeira medida e daí em diante corrige a
+// deriva lenta do barômetro.
+
+// Ruídos do modelo (desvio padrão) e das medidas
+#define KV_RUIDO_ACEL 0.5f      // m/s² (ruído + erro de atitude na projeção)
+#define KV_RUIDO_BIAS 0.01f     // m/s² por raiz de s
+#define KV_RUIDO_BARO 0.5f      // m
+#define KV_RUIDO_GPS 5.0f       // m
+#define KV_PORTA_SIGMAS 5.0f    // Inovação acima disso é descartada
+
+typedef struct {
+    float x[3];        // Altitude (m), velocidade vertical (m/s), bias (m/s²)
+    float P[3][3];
+    bool inicializado;           // Primeira medida do barômetro já chegou
+    bool gps_referenciado;
+    float referencia_gps;        // Altitude MSL do zero do barômetro
+    uint32_t correcoes_baro;
+    uint32_t correcoes_gps;
+    uint32_t rejeicoes;          // Medidas fora da porta de inovação
+} kalman_vertical_t;
+
+void kalman_vertical_inicializar(kalman_vertical_t *kv);
+
+// Aceleração vertical para cima (m/s², sem a gravidade)
+void kalman_vertical_propagar(kalman_vertical_t *kv, float aceleracao_vertical, float dt);
+
+// Altitude barométrica relativa à pressão base (m). A primeira medida
+// inicializa o estado.
+void kalman_vertical_corrigir_baro(kalman_vertical_t *kv, float altitude);
+
+// Altitude MSL do GGA (m); ignorada até o barômetro inicializar o estado
+void kalman_vertical_corrigir_gps(kalman_vertical_t *kv, float altitude_msl);
+
+// VERT|correcoes_baro|correcoes_gps|rejeicoes|bias_acel
+void kalman_vertical_imprimir_estatisticas(const kalman_vertical_t *kv);
+
+#endif
@@ -0,0 +1,106 @@
+#include "matematica_rapida.h"
+#include "codigo_ram.h"
+
+// Fora do .rodata quando o caminho crítico roda da SRAM: a tabela é lida a
+// cada amostra e não deve depender da cache do XIP
+#ifdef AERO_CODIGO_RAM
+#define MAT_TABELA static
+#else
+#define MAT_TABELA static const
+#endif
+
+// altitude[i] = 44330 * (1 - r^(1/5.255)), r = 0.6 + i / 512. Gerada com:
+// python3 -c "print([round(44330*(1-(0.6+i/512)**(1/5.255)),4) for i in range(257)])"
+MAT_TABELA float tabela_altitude[MAT_ALTITUDE_INTERVALOS + 1] = {
+    4106.3911f, 4081.5074f, 4056.6890f, 4031.9354f, 4007.2464f, 3982.6216f,
+    3958.0605f, 3933.5628f, 3909.1282f, 3884.7563f, 3860.4467f, 3836.1991f,
+    3812.0132f, 3787.8884f, 3763.8247f, 3739.8215f, 3715.8785f, 3691.9955f,
+    3668.1720f, 3644.4078f, 3620.7025f, 3597.0558f, 3573.4673f, 3549.9368f,
+    3526.4639f, 3503.0484f, 3479.6898f, 3456.3879f, 3433.1425f, 3409.9531f,
+    3386.8195f, 3363.7414f, 3340.7184f, 3317.7504f, 3294.8369f, 3271.9778f,
+    3249.1727f, 3226.4213f, 3203.7234f, 3181.0787f, 3158.4869f, 3135.9477f,
+    3113.4608f, 3091.0260f, 3068.6431f, 3046.3117f, 3024.0315f, 3001.8024f,
+    2979.6241f, 2957.4962f, 2935.4186f, 2913.3910f, 2891.4131f, 2869.4847f,
+    2847.6055f, 2825.7754f, 2803.9939f, 2782.2610f, 2760.5764f, 2738.9397f,
+    2717.3509f, 2695.8096f, 2674.3156f, 2652.8688f, 2631.4687f, 2610.1153f,
+    2588.8083f, 2567.5475f, 2546.3327f, 2525.1636f, 2504.0399f, 2482.9616f,
+    2461.9284f, 2440.9400f, 2419.9963f, 2399.0970f, 2378.2420f, 2357.4309f,
+    2336.6637f, 2315.9401f, 2295.2599f, 2274.6229f, 2254.0289f, 2233.4777f,
+    2212.9691f, 2192.5029f, 2172.0789f, 2151.6969f, 2131.3568f, 2111.0583f,
+    2090.8012f, 2070.5853f, 2050.4106f, 2030.2767f, 2010.1835f, 1990.1308f,
+    1970.1185f, 1950.1463f, 1930.2141f, 1910.3216f, 1890.4688f, 1870.6554f,
+    1850.8813f, 1831.1463f, 1811.4501f, 1791.7928f, 1772.1740f, 1752.5936f,
+    1733.0514f, 1713.5474f, 1694.0812f, 1674.6528f, 1655.2619f, 1635.9085f,
+    1616.5923f, 1597.3133f, 1578.0711f, 1558.8658f, 1539.6971f, 1520.5648f,
+    1501.4689f, 1482.4091f, 1463.3853f, 1444.3974f, 1425.4451f, 1406.5285f,
+    1387.6472f, 1368.8012f, 1349.9903f, 1331.2144f, 1312.4733f, 1293.7669f,
+    1275.0950f, 1256.4575f, 1237.8543f, 1219.2851f, 1200.7499f, 1182.2486f,
+    1163.7810f, 1145.3469f, 1126.9462f, 1108.5789f, 1090.2446f, 1071.9434f,
+    1053.6751f, 1035.4395f, 1017.2366f, 999.0661f, 980.9281f, 962.8222f,
+    944.7485f, 926.7067f, 908.6968f, 890.7186f, 872.7720f, 854.8570f,
+    836.9732f, 819.1207f, 801.2993f, 783.5089f, 765.7494f, 748.0206f,
+    730.3225f, 712.6549f, 695.0176f, 677.4107f, 659.8339f, 642.2872f,
+    624.7704f, 607.2834f, 589.8262f, 572.3985f, 555.0003f, 537.6315f,
+    520.2920f, 502.9816f, 485.7002f, 468.4478f, 451.2242f, 434.0294f,
+    416.8631f, 399.7253f, 382.6160f, 365.5349f, 348.4821f, 331.4573f,
+    314.4605f, 297.4916f, 280.5504f, 263.6370f, 246.7511f, 229.8927f,
+    213.0617f, 196.2579f, 179.4814f, 162.7319f, 146.0094f, 129.3138f,
+    112.6449f, 96.0028f, 79.3873f, 62.7982f, 46.2356f, 29.6993f,
+    13.1892f, -3.2947f, -19.7526f, -36.1846f, -52.5907f, -68.9710f,
+    -85.3257f, -101.6548f, -117.9584f, -134.2366f, -150.4894f, -166.7171f,
+    -182.9196f, -199.0970f, -215.2495f, -231.3771f, -247.4799f, -263.5579f,
+    -279.6114f, -295.6403f, -311.6448f, -327.6248f, -343.5806f, -359.5122f,
+    -375.4196f, -391.3030f, -407.1624f, -422.9979f, -438.8097f, -454.5977f,
+    -470.3620f, -486.1028f, -501.8201f, -517.5140f, -533.1845f, -548.8318f,
+    -564.4559f, -580.0569f, -595.6349f, -611.1900f, -626.7221f, -642.2315f,
+    -657.7181f, -673.1821f, -688.6235f, -704.0424f, -719.4389f, -734.8130f,
+    -750.1649f, -765.4945f, -780.8020f, -796.0874f, -811.3508f,
+};
+
+static inline float polinomio_seno(float x) {
+    float x2 = x * x;
+    return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f))));
+}
+
+static inline float polinomio_cosseno(float x) {
+    float x2 = x * x;
+    return 1.0f + x2 * (-0.5f + x2 * (1.0f / 24.0f + x2 * (-1.0f / 720.0f + x2 * (1.0f / 40320.0f))));
+}
+
+void AERO_RAM_FUNC(mat_sen_cos_graus)(float graus, float *seno, float *cosseno) {
+    float q = graus * (1.0f / 90.0f);
+    int32_t k = (int32_t)(q >= 0.0f ? q + 0.5f : q - 0.5f);  // Quadrante mais próximo
+    float x = (graus - (float)k * 90.0f) * MAT_GRAUS_PARA_RAD;  // [-pi/4, pi/4]
+    float s = polinomio_seno(x);
+    float c = polinomio_cosseno(x);
+
+    switch (k & 3) {
+        case 0: *seno = s;  *cosseno = c;  break;
+        case 1: *seno = c;  *cosseno = -s; break;
+        case 2: *seno = -s; *cosseno = -c; break;
+        default: *seno = -c; *cosseno = s; break;
+    }
+}
+
+float AERO_RAM_FUNC(mat_sen_graus)(float graus) {
+    float s, c;
+    mat_sen_cos_graus(graus, &s, &c);
+    return s;
+}
+
+float AERO_RAM_FUNC(mat_cos_graus)(float graus) {
+    float s, c;
+    mat_sen_cos_graus(graus, &s, &c);
+    return c;
+}
+
+float AERO_RAM_FUNC(mat_altitude_razao_pressao)(float razao) {
+    float x = (razao - MAT_ALTITUDE_RAZAO_MIN) * MAT_ALTITUDE_PASSOS_POR_UNIDADE;
+    if (!(x >= 0.0f && x < (float)MAT_ALTITUDE_INTERVALOS)) {
+        return 44330.0f * (1.0f - powf(razao, 1.0f / 5.255f));
+    }
+
+    int32_t i = (int32_t)x;
+    float f = x - (float)i;
+    return tabela_altitude[i] + f * (tabela_altitude[i + 1] - tabela_altitude[i]);
+}
@@ -0,0 +1,83 @@
+#ifndef MATEMATICA_RAPIDA_H
+#define MATEMATICA_RAPIDA_H
+
+#include <stdint.h>
+#include <math.h>
+
+// Núcleos de matemática em float para o caminho de cada amostra, com erro
+// máximo documentado. Não dependem do SDK: o mesmo código roda no host
+// (ver matematica_rapida_benchmark.c).
+
+#define MAT_PI 3.14159265f
+#define MAT_MEIO_PI 1.57079633f
+#define MAT_GRAUS_PARA_RAD 0.0174532925f
+#define MAT_RAD_PARA_GRAUS 57.2957795f
+#define GRAVIDADE 9.81f  // m/s², escala da IMU, do AHRS e do canal vertical
+
+// Raiz quadrada pela instrução VSQRT.F32 do FPU (14 ciclos no M33), sem o
+// tratamento de errno da sqrtf. Exata (arredondamento IEEE); x < 0 dá NaN.
+static inline float mat_sqrt(float x) {
+#if defined(__ARM_FP) && (__ARM_FP & 4)
+    float r;
+    __asm__("vsqrt.f32 %0, %1" : "=t"(r) : "t"(x));
+    return r;
+#else
+    return sqrtf(x);
+#endif
+}
+
+// 1/sqrt(x) por aproximação de bits + 2 iterações de Newton, sem divisão.
+// Erro relativo < 5e-6 para x > 0 normal.
+static inline float mat_rsqrt(float x) {
+    union { float f; uint32_t u; } v = { x };
+    v.u = 0x5f375a86u - (v.u >> 1);
+    float y = v.f;
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y;
+}
+
+// atan2 por polinômio mínimo-máximo de grau 11 em [0, 1] e redução por
+// octante. Erro máximo 2e-6 rad (1.1e-4 graus); atan2(0, 0) = 0.
+static inline float mat_atan2(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float maior = ax > ay ? ax : ay;
+    float menor = ax > ay ? ay : ax;
+    if (maior == 0.0f) return 0.0f;
+
+    float z = menor / maior;
+    float z2 = z * z;
+    float a = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f +
+              z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+
+    if (ay > ax) a = MAT_MEIO_PI - a;
+    if (x < 0.0f) a = MAT_PI - a;
+    return y < 0.0f ? -a : a;
+}
+
+static inline float mat_atan2_graus(float y, float x) {
+    return mat_atan2(y, x) * MAT_RAD_PARA_GRAUS;
+}
+
+// Seno e cosseno de ângulos em graus: redução ao quadrante mais próximo e
+// séries de Taylor em [-45°, 45°]. Erro absoluto < 4e-7 para |graus| < 1e4
+// (acima disso domina o arredondamento da redução).
+void mat_sen_cos_graus(float graus, float *seno, float *cosseno);
+float mat_sen_graus(float graus);
+float mat_cos_graus(float graus);
+
+// Altitude barométrica 44330 * (1 - r^(1/5.255)) para r = p / p_base, por
+// tabela de 257 pontos em r = [0.6, 1.1] (~4100 m a -810 m) com
+// interpolação linear. Erro máximo 8 mm dentro da faixa; fora dela cai
+// na powf.
+#define MAT_ALTITUDE_RAZAO_MIN 0.6f
+#define MAT_ALTITUDE_INTERVALOS 256
+#define MAT_ALTITUDE_PASSOS_POR_UNIDADE 512.0f  // 1 / passo de r
+
+float mat_altitude_razao_pressao(float razao);
+
+// MATH|nucleo|tempo_rapida|tempo_libm|erro_max para cada núcleo
+// (matematica_rapida_benchmark.c)
+void matematica_rapida_benchmark(void);
+
+#endif
@@ -0,0 +1,113 @@
+// Benchmark dos núcleos de matematica_rapida contra a libm, com o erro
+// máximo medido contra a referência em double.
+//
+// No alvo: opção AERO_MATEMATICA_BENCHMARK (ciclos por chamada, DWT).
+// No host (ns por chamada):
+//   gcc -O2 -DMAT_BENCHMARK_HOST -Ilib lib/matematica_rapida.c lib/matematica_rapida_benchmark.c -lm
+#include <stdio.h>
+#include "matematica_rapida.h"
+
+#ifdef __arm__
+#include "desempenho.h"
+#define UNIDADE "ciclos"
+static inline uint32_t relogio(void) {
+    return desempenho_ciclos();
+}
+#else
+#include <time.h>
+#define UNIDADE "ns"
+static inline uint32_t relogio(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)(t.tv_sec * 1000000000ull + t.tv_nsec);
+}
+#endif
+
+#define MAT_BENCHMARK_N 1024
+
+static float entrada_a[MAT_BENCHMARK_N];
+static float entrada_b[MAT_BENCHMARK_N];
+static volatile float sumidouro;  // Impede que o laço seja eliminado
+
+// Valores determinísticos em [min, max)
+static void preencher(float *v, float min, float max, uint32_t semente) {
+    for (int i = 0; i < MAT_BENCHMARK_N; i++) {
+        semente = semente * 1664525u + 1013904223u;
+        v[i] = min + (max - min) * (float)(semente >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+// Tempo médio por chamada de 'expr', avaliada com a = entrada_a[i], b = entrada_b[i]
+#define MEDIR(expr, media) do {                                   \
+        float acc = 0.0f;                                         \
+        uint32_t t0 = relogio();                                  \
+        for (int i = 0; i < MAT_BENCHMARK_N; i++) {               \
+            float a = entrada_a[i], b = entrada_b[i];             \
+            (void)a; (void)b;                                     \
+            acc += (expr);                                        \
+        }                                                         \
+        sumidouro = acc;                                          \
+        media = (float)(relogio() - t0) / MAT_BENCHMARK_N;        \
+    } while (0)
+
+// Maior diferença entre 'expr' e a referência 'ref' (double), absoluta
+// ou relativa à referência
+#define ERRO_MAX(expr, ref, relativo, erro) do {                  \
+        erro = 0.0;                                               \
+        for (int i = 0; i < MAT_BENCHMARK_N; i++) {               \
+            float a = entrada_a[i], b = entrada_b[i];             \
+            (void)a; (void)b;                                     \
+            double r = (ref);                                     \
+            double e = fabs((double)(expr) - r);                  \
+            if (relativo) e /= fabs(r);                           \
+            if (e > erro) erro = e;                               \
+        }                                                         \
+    } while (0)
+
+static void imprimir(const char *nome, float rapida, float libm, double erro) {
+    printf("MATH|%s|%.1f|%.1f|%.2e\n", nome, (double)rapida, (double)libm, erro);
+}
+
+void matematica_rapida_benchmark(void) {
+    float rapida, libm;
+    double erro;
+
+    printf("MATH|nucleo|" UNIDADE "_rapida|" UNIDADE "_libm|erro_max\n");
+
+    preencher(entrada_a, -20.0f, 20.0f, 1);
+    preencher(entrada_b, -20.0f, 20.0f, 2);
+    MEDIR(mat_atan2(a, b), rapida);
+    MEDIR(atan2f(a, b), libm);
+    ERRO_MAX(mat_atan2(a, b), atan2((double)a, (double)b), 0, erro);
+    imprimir("atan2", rapida, libm, erro);
+
+    preencher(entrada_a, 0.001f, 200.0f, 3);
+    MEDIR(mat_sqrt(a), rapida);
+    MEDIR(sqrtf(a), libm);
+    ERRO_MAX(mat_sqrt(a), sqrt((double)a), 1, erro);
+    imprimir("sqrt", rapida, libm, erro);
+
+    MEDIR(mat_rsqrt(a), rapida);
+    MEDIR(1.0f / sqrtf(a), libm);
+    ERRO_MAX(mat_rsqrt(a), 1.0 / sqrt((double)a), 1, erro);
+    imprimir("rsqrt", rapida, libm, erro);
+
+    preencher(entrada_a, -720.0f, 720.0f, 4);
+    MEDIR(mat_cos_graus(a), rapida);
+    MEDIR(cosf(a * MAT_GRAUS_PARA_RAD), libm);
+    ERRO_MAX(mat_cos_graus(a), cos((double)a * 3.14159265358979323846 / 180.0), 0, erro);
+    imprimir("cos_graus", rapida, libm, erro);
+
+    preencher(entrada_a, 0.6f, 1.1f, 5);
+    MEDIR(mat_altitude_razao_pressao(a), rapida);
+    MEDIR(44330.0f * (1.0f - powf(a, 1.0f / 5.255f)), libm);
+    ERRO_MAX(mat_altitude_razao_pressao(a), 44330.0 * (1.0 - pow((double)a, 1.0 / 5.255)), 0, erro);
+    imprimir("altitude", rapida, libm, erro);
+}
+
+#ifdef MAT_BENCHMARK_HOST
+int main(void) {
+    matematica_rapida_benchmark();
+    return 0;
+}
+#endif
@@ -1,120 +1,624 @@
 #include <stdio.h>
 #include <math.h>
 #include "mpu6500.h"
+#include "hardware/irq.h"
+#include "desempenho.h"
+#include "matematica_rapida.h"
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
 
 // Variáveis globais definidas aqui
 float bias_giro[3] = {0};
 float erro_aceleracao[3] = {0};
 
+// Destino das leituras por DMA (rajada de registradores ou lote da FIFO),
+// alinhado em palavras para a troca de bytes do lote
+static uint32_t buffer_dma_palavras[MPU6500_LOTE_MAX * MPU6500_BYTES_AMOSTRA_FIFO / 4];
+#define buffer_dma ((uint8_t *)buffer_dma_palavras)
+
+// Escalas de contagem para unidade física (multiplicação em vez de divisão)
+#define ESCALA_ACELERACAO (GRAVIDADE / SENSIBILIDADE_ACELERACAO)  // m/s² por contagem
+#define ESCALA_GIRO (1.0f / SENSIBILIDADE_GIRO)                    // °/s por contagem
+
+// Offsets de calibração em contagens, empacotados como as palavras de
+// mpu6500_bruto_t: [ax ay] [az gx] [gy gz]
+static uint32_t offsets_empacotados[3] = {0};
+
+static void mpu6500_trocar_bytes_lote(const uint32_t *origem, uint32_t *destino, uint16_t palavras);
+
+static uint32_t mpu6500_configurar_etapa(void *contexto, uint8_t etapa);
+static void mpu6500_configurar_registradores_fifo(void);
+
+// Modo FIFO (0 = desativado)
+static uint16_t taxa_fifo_hz = 0;
+static volatile uint32_t interrupcoes_int = 0;
+static volatile uint64_t ultimo_int_us = 0;
+static uint16_t amostras_pedidas = 0;
+static uint64_t tempo_lote_us = 0;  // Instante da primeira amostra pedida
+mpu6500_fifo_estatisticas_t mpu6500_fifo_stats = {0};
+
+#ifdef AERO_MPU6500_SPI
+// USER_CTRL sempre com I2C_IF_DIS, senão o sensor volta a escutar o I2C
+#define USER_CTRL_INTERFACE 0x10
+
+mpu6500_spi_estatisticas_t mpu6500_spi_stats = {0};
+static uint32_t spi_baud_atual = 0;
+
+// Pela folha de dados só a leitura dos registradores de sensor e de
+// interrupção (0x3A..0x48) vai a 20 MHz; todos os outros, FIFO_COUNT e
+// FIFO_R_W inclusive, ficam em 1 MHz
+static void AERO_RAM_FUNC(mpu6500_spi_ajustar_clock)(uint8_t reg, bool leitura) {
+    bool rapido = leitura && reg >= 0x3A && reg <= 0x48;
+    uint32_t baud = rapido ? MPU6500_SPI_BAUD_DADOS : MPU6500_SPI_BAUD_CONFIG;
+    if (baud != spi_baud_atual) {
+        spi_set_baudrate(MPU6500_SPI_PORT, baud);
+        spi_baud_atual = baud;
+    }
+}
+
+// Quadro SPI: 1 byte de endereço (bit 7 = leitura) seguido dos dados
+static bool mpu6500_escrever(uint8_t reg, uint8_t dado) {
+    uint8_t buf[] = {reg & 0x7F, dado};
+    mpu6500_spi_ajustar_clock(reg, false);
+    gpio_put(MPU6500_SPI_CS_PIN, 0);
+    spi_write_blocking(MPU6500_SPI_PORT, buf, 2);
+    gpio_put(MPU6500_SPI_CS_PIN, 1);
+    mpu6500_spi_stats.transacoes++;
+    return true;
+}
+
+static bool AERO_RAM_FUNC(mpu6500_ler)(uint8_t reg, uint8_t *buf, uint16_t tamanho) {
+    uint8_t endereco = reg | 0x80;
+    mpu6500_spi_ajustar_clock(reg, true);
+    gpio_put(MPU6500_SPI_CS_PIN, 0);
+    spi_write_blocking(MPU6500_SPI_PORT, &endereco, 1);
+    spi_read_blocking(MPU6500_SPI_PORT, 0x00, buf, tamanho);
+    gpio_put(MPU6500_SPI_CS_PIN, 1);
+    mpu6500_spi_stats.transacoes++;
+    mpu6500_spi_stats.bytes += tamanho + 1;
+    return true;
+}
+
+// A rajada de 14 bytes a 20 MHz leva ~6 us e o maior lote da FIFO
+// (193 bytes) a 1 MHz ~1,6 ms: a "rajada assíncrona" é feita na hora e
+// apenas o resultado é guardado para a conclusão
+static bool rajada_ok = false;
+
+static bool AERO_RAM_FUNC(mpu6500_iniciar_rajada)(uint8_t reg, uint8_t *buf, uint16_t tamanho) {
+    rajada_ok = mpu6500_ler(reg, buf, tamanho);
+    return rajada_ok;
+}
+
+static bool AERO_RAM_FUNC(mpu6500_aguardar_rajada)(void) {
+    return rajada_ok;
+}
+
+static void mpu6500_barramento_inicializar(void) {
+    spi_init(MPU6500_SPI_PORT, MPU6500_SPI_BAUD_CONFIG);
+    spi_baud_atual = MPU6500_SPI_BAUD_CONFIG;
+    spi_set_format(MPU6500_SPI_PORT, 8, SPI_CPOL_1, SPI_CPHA_1, SPI_MSB_FIRST);  // Modo 3
+    gpio_set_function(MPU6500_SPI_SCK_PIN, GPIO_FUNC_SPI);
+    gpio_set_function(MPU6500_SPI_MOSI_PIN, GPIO_FUNC_SPI);
+    gpio_set_function(MPU6500_SPI_MISO_PIN, GPIO_FUNC_SPI);
+
+    gpio_init(MPU6500_SPI_CS_PIN);
+    gpio_put(MPU6500_SPI_CS_PIN, 1);
+    gpio_set_dir(MPU6500_SPI_CS_PIN, GPIO_OUT);
+}
+#else
+#define USER_CTRL_INTERFACE 0x00
+
+dispositivo_i2c_t mpu6500_i2c = {
+    .nome = "MPU6500",
+    .i2c = I2C_PORT,
+    .endereco = MPU6500_ENDERECO,
+    .sda_pin = SDA_PIN,
+    .scl_pin = SCL_PIN,
+    .baudrate = 400 * 1000,
+    .timeout_us = MPU6500_TIMEOUT_US,
+    .falhas_para_recuperar = 3,
+    .reinicializar = mpu6500_configurar_etapa,
+};
+
 // Funções auxiliares I2C
-static void mpu6500_escrever(uint8_t reg, uint8_t dado) {
-    uint8_t buf[] = {reg, dado};
-    i2c_write_blocking(I2C_PORT, MPU6500_ENDERECO, buf, 2, false);
+static bool mpu6500_escrever(uint8_t reg, uint8_t dado) {
+    return i2c_dispositivo_escrever_registrador(&mpu6500_i2c, reg, &dado, 1);
+}
+
+static bool AERO_RAM_FUNC(mpu6500_ler)(uint8_t reg, uint8_t *buf, uint16_t tamanho) {
+    return i2c_dispositivo_ler_registrador(&mpu6500_i2c, reg, buf, tamanho);
 }
 
-static void mpu6500_ler(uint8_t reg, uint8_t *buf, uint16_t tamanho) {
-    i2c_write_blocking(I2C_PORT, MPU6500_ENDERECO, &reg, 1, true);
-    i2c_read_blocking(I2C_PORT, MPU6500_ENDERECO, buf, tamanho, false);
+// Rajada por DMA no i2c1, em paralelo com o BME680 no i2c0
+static bool AERO_RAM_FUNC(mpu6500_iniciar_rajada)(uint8_t reg, uint8_t *buf, uint16_t tamanho) {
+    return i2c_dispositivo_iniciar_leitura_dma(&mpu6500_i2c, reg, buf, tamanho);
 }
 
-// Inicialização do sensor
+static bool AERO_RAM_FUNC(mpu6500_aguardar_rajada)(void) {
+    return i2c_dispositivo_aguardar_dma(&mpu6500_i2c);
+}
+
+static void mpu6500_barramento_inicializar(void) {
+    i2c_dispositivo_inicializar(&mpu6500_i2c);
+    i2c_dispositivo_dma_inicializar(&mpu6500_i2c);
+}
+#endif
+
+// Inicialização do sensor: as etapas da configuração com espera bloqueante
 void mpu6500_inicializar() {
-    mpu6500_escrever(0x6B, 0x00);  // Sai do modo de suspensão
-    sleep_ms(100);
-    mpu6500_escrever(0x6B, 0x01);  // Usa giroscópio X como clock
-    sleep_ms(100);
+    mpu6500_barramento_inicializar();
+    for (uint8_t etapa = 0;; etapa++) {
+        uint32_t espera_us = mpu6500_configurar_etapa(NULL, etapa);
+        if (espera_us == 0) break;
+        sleep_us(espera_us);
+    }
+}
+
+// false enquanto o sensor é reconfigurado depois de uma recuperação do
+// barramento (avança as etapas)
+#ifdef AERO_MPU6500_SPI
+static bool mpu6500_disponivel(void) {
+    return true;
+}
+#else
+static bool AERO_RAM_FUNC(mpu6500_disponivel)(void) {
+    return i2c_dispositivo_manter(&mpu6500_i2c);
+}
+#endif
+
+uint8_t mpu6500_ler_id(void) {
+    uint8_t id = 0;
+    mpu6500_ler(0x75, &id, 1);  // WHO_AM_I
+    return id;
+}
+
+// Registradores de configuração em etapas; retorna a espera até a próxima
+// (0 = concluída). Também usada após recuperar o barramento.
+static uint32_t mpu6500_configurar_etapa(void *contexto, uint8_t etapa) {
+    switch (etapa) {
+        case 0:
+            mpu6500_escrever(0x6B, 0x00);  // Sai do modo de suspensão
+            return 100000;
+        case 1:
+            mpu6500_escrever(0x6B, 0x01);  // Usa giroscópio X como clock
+            return 100000;
+    }
+    mpu6500_escrever(0x6A, USER_CTRL_INTERFACE);
 
     mpu6500_escrever(0x1A, 0x03);  // DLPF giroscópio 41 Hz
     mpu6500_escrever(0x1B, 0x08);  // ±500 °/s
     mpu6500_escrever(0x1D, 0x03);  // DLPF acelerômetro 44.8 Hz
     mpu6500_escrever(0x1C, 0x08);  // ±4g
+
+    if (taxa_fifo_hz) {
+        mpu6500_configurar_registradores_fifo();
+    }
+    return 0;
+}
+
+// Interrupção de dado pronto: conta amostras produzidas e marca o instante
+// da mais recente, usado como âncora de tempo do lote. A contagem sobe
+// depois do instante: um leitor que a vê igual antes e depois de ler o
+// instante leu um valor inteiro e atual.
+static void AERO_RAM_FUNC(mpu6500_int_irq)(void) {
+    if (gpio_get_irq_event_mask(MPU6500_INT_PIN) & GPIO_IRQ_EDGE_RISE) {
+        gpio_acknowledge_irq(MPU6500_INT_PIN, GPIO_IRQ_EDGE_RISE);
+        ultimo_int_us = time_us_64();
+        interrupcoes_int++;
+    }
+}
+
+static void mpu6500_configurar_registradores_fifo(void) {
+    mpu6500_escrever(0x1A, 0x40 | 0x03);                   // FIFO_MODE: para de gravar quando cheia; DLPF 41 Hz
+    mpu6500_escrever(0x19, (uint8_t)(1000 / taxa_fifo_hz - 1));  // SMPLRT_DIV sobre a taxa interna de 1 kHz
+    mpu6500_escrever(0x37, 0x00);  // INT ativo alto, push-pull, pulso de 50 us
+    mpu6500_escrever(0x38, 0x01);  // RAW_RDY_EN
+    mpu6500_escrever(0x23, 0x78);  // Giro XYZ + acelerômetro na FIFO (12 bytes/amostra)
+    mpu6500_escrever(0x6A, USER_CTRL_INTERFACE | 0x04);  // FIFO_RST
+    mpu6500_escrever(0x6A, USER_CTRL_INTERFACE | 0x40);  // FIFO_EN
+}
+
+bool mpu6500_configurar_fifo(uint16_t taxa_hz) {
+    if (taxa_hz < 4 || taxa_hz > 1000) return false;
+    taxa_fifo_hz = taxa_hz;
+
+    gpio_init(MPU6500_INT_PIN);
+    gpio_set_dir(MPU6500_INT_PIN, GPIO_IN);
+    gpio_add_raw_irq_handler(MPU6500_INT_PIN, mpu6500_int_irq);
+    gpio_set_irq_enabled(MPU6500_INT_PIN, GPIO_IRQ_EDGE_RISE, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    mpu6500_configurar_registradores_fifo();
+    interrupcoes_int = 0;
+    return true;
+}
+
+uint16_t mpu6500_taxa_fifo(void) {
+    return taxa_fifo_hz;
+}
+
+void mpu6500_imprimir_estatisticas_fifo(void) {
+    printf("FIFO|%u|%u|%u|%u\n",
+           mpu6500_fifo_stats.amostras, mpu6500_fifo_stats.lotes,
+           mpu6500_fifo_stats.estouros, interrupcoes_int);
+}
+
+uint16_t AERO_RAM_FUNC(mpu6500_iniciar_leitura_fifo)(void) {
+    uint8_t contagem[2];
+    amostras_pedidas = 0;
+    if (!mpu6500_disponivel()) return 0;
+
+    // FIFO_COUNT e o último pulso de dado pronto precisam ser do mesmo
+    // intervalo entre amostras: se chegou um pulso durante a leitura, a
+    // contagem pode ou não incluir a amostra dele, e é lida de novo
+    uint32_t interrupcoes;
+    uint64_t ancora_us;
+    for (int tentativa = 0; tentativa < 2; tentativa++) {
+        interrupcoes = interrupcoes_int;
+        if (!mpu6500_ler(0x72, contagem, 2)) return 0;  // FIFO_COUNT_H/L
+        ancora_us = interrupcoes ? ultimo_int_us : time_us_64();  // Sem pulsos: hora da leitura
+        if (interrupcoes_int == interrupcoes) break;
+    }
+
+    uint16_t bytes = ((contagem[0] & 0x1F) << 8) | contagem[1];
+    uint16_t disponiveis = bytes / MPU6500_BYTES_AMOSTRA_FIFO;
+
+    // Com FIFO_MODE=1 a FIFO cheia deixa de gravar: houve perda, e as
+    // amostras retidas são antigas e sem relação com a âncora de tempo.
+    // O lote é descartado e a FIFO recomeça vazia.
+    if (bytes > MPU6500_TAMANHO_FIFO - MPU6500_BYTES_AMOSTRA_FIFO) {
+        mpu6500_escrever(0x6A, USER_CTRL_INTERFACE | 0x40 | 0x04);  // FIFO_EN | FIFO_RST
+        mpu6500_fifo_stats.estouros++;
+        return 0;
+    }
+    if (disponiveis == 0) return 0;
+
+    // A mais nova das 'disponiveis' é a do último pulso; o lote começa
+    // pela mais antiga, e o resto fica para o próximo ciclo
+    tempo_lote_us = ancora_us - (uint64_t)(disponiveis - 1) * (1000000u / taxa_fifo_hz);
+
+    uint16_t n = disponiveis < MPU6500_LOTE_MAX ? disponiveis : MPU6500_LOTE_MAX;
+    if (!mpu6500_iniciar_rajada(0x74, buffer_dma, n * MPU6500_BYTES_AMOSTRA_FIFO)) {
+        return 0;
+    }
+    amostras_pedidas = n;
+    return n;
+}
+
+uint16_t AERO_RAM_FUNC(mpu6500_concluir_leitura_fifo)(mpu6500_bruto_t *amostras, uint64_t *tempo_us) {
+    uint16_t n = amostras_pedidas;
+    amostras_pedidas = 0;
+    if (n == 0) return 0;
+    *tempo_us = tempo_lote_us;
+
+    if (!mpu6500_aguardar_rajada()) {
+        // Alinhamento da FIFO incerto após falha: recomeçar vazia
+        mpu6500_escrever(0x6A, USER_CTRL_INTERFACE | 0x40 | 0x04);
+        mpu6500_fifo_stats.estouros++;
+        return 0;
+    }
+
+    // Ordem na FIFO: ACCEL_XOUT..ACCEL_ZOUT, GYRO_XOUT..GYRO_ZOUT, a mesma
+    // de mpu6500_bruto_t; só falta trocar os bytes de cada metade
+    for (int k = 0; k < n; k++) {
+        mpu6500_trocar_bytes_lote(&buffer_dma_palavras[k * 3], amostras[k].palavras, 3);
+    }
+
+    mpu6500_fifo_stats.lotes++;
+    mpu6500_fifo_stats.amostras += n;
+    mpu6500_fifo_stats.interrupcoes = interrupcoes_int;
+    mpu6500_fifo_stats.ultimo_int_us = ultimo_int_us;
+    return n;
 }
 
 // Calibração giroscópio
 void calibra_giroscopio(){
     printf("Calibrando giroscópio... mantenha o sensor parado.\n");
     int32_t soma_giro[3] = {0};
+    int validas = 0;
 
     for (int i = 0; i < NUM_AMOSTRAS; i++) {
         uint8_t buffer[6];
         int16_t leitura_bruta[3];
 
-        mpu6500_ler(0x43, buffer, 6);
-        for (int j = 0; j < 3; j++) {
-            leitura_bruta[j] = (int16_t)((buffer[j * 2] << 8) | buffer[j * 2 + 1]);
-            soma_giro[j] += leitura_bruta[j];
+        if (mpu6500_ler(0x43, buffer, 6)) {
+            for (int j = 0; j < 3; j++) {
+                leitura_bruta[j] = (int16_t)((buffer[j * 2] << 8) | buffer[j * 2 + 1]);
+                soma_giro[j] += leitura_bruta[j];
+            }
+            validas++;
         }
         sleep_ms(5);
     }
+    if (validas == 0) validas = 1;
 
     for (int j = 0; j < 3; j++) {
-        bias_giro[j] = (soma_giro[j] / (float)NUM_AMOSTRAS) / SENSIBILIDADE_GIRO;
-        printf("Bias giroscópio eixo %c: %.2f °/s\n", 'X' + j, bias_giro[j]);
+        bias_giro[j] = (soma_giro[j] / (float)validas) / SENSIBILIDADE_GIRO;
+        printf("Bias giroscópio eixo %c: %.2f °/s\n", 'X' + j, (double)bias_giro[j]);
     }
+    mpu6500_atualizar_offsets();
 }
 
 // Calibração acelerômetro
 void calibra_aceleracao(){
     printf("Calibrando acelerômetro... mantenha o sensor parado.\n");
     int32_t soma_aceleracao[3] = {0};
+    int validas = 0;
 
     for(int i = 0; i < NUM_AMOSTRAS; i++) {
         uint8_t buffer[6];
         int16_t leitura_bruta[3];
-        mpu6500_ler(0x3B, buffer, 6);
+        if (!mpu6500_ler(0x3B, buffer, 6)) {
+            sleep_ms(5);
+            continue;
+        }
 
         for (int j = 0; j < 3; j++) {
             leitura_bruta[j] = (int16_t)((buffer[j * 2] << 8) | buffer[j * 2 + 1]);
             soma_aceleracao[j] += leitura_bruta[j];
         }
+        validas++;
         sleep_ms(5);
     }
+    if (validas == 0) validas = 1;
 
     for (int j = 0; j < 3; j++) {
-        float media = (soma_aceleracao[j] / (float)NUM_AMOSTRAS) / SENSIBILIDADE_ACELERACAO;
+        float media = (soma_aceleracao[j] / (float)validas) / SENSIBILIDADE_ACELERACAO;
 
         if (j == 2) {
-            erro_aceleracao[j] = media - 1.0;  // Z ≈ +1g
+            erro_aceleracao[j] = media - 1.0f;  // Z ≈ +1g
         } else {
             erro_aceleracao[j] = media;
         }
-        printf("Erro acelerômetro %c: %.2f g\n", 'X' + j, erro_aceleracao[j]);
+        printf("Erro acelerômetro %c: %.2f g\n", 'X' + j, (double)erro_aceleracao[j]);
     }
+    mpu6500_atualizar_offsets();
 }
 
-// Leitura com filtro complementar
-void leitura(float bias_giro[3], float erro_aceleracao[3], float *theta, float *phi, float dt) {
-    int16_t aceleracao_bruto[3], giro_bruto[3];
-    float aceleracao[3], giro[3];
-    uint8_t buffer[6];
-
-    // Acelerômetro
-    mpu6500_ler(0x3B, buffer, 6);
+// Rajada de 14 bytes a partir de ACCEL_XOUT_H: aceleração, temperatura, giro
+static void AERO_RAM_FUNC(mpu6500_decodificar)(const uint8_t *buffer, mpu6500_bruto_t *bruto) {
     for (int i = 0; i < 3; i++) {
-        aceleracao_bruto[i] = (int16_t)((buffer[i * 2] << 8) | buffer[i * 2 + 1]);
-        float erro_corrigido = copysign(erro_aceleracao[i], aceleracao_bruto[i]);
-        aceleracao[i] = ((aceleracao_bruto[i] / SENSIBILIDADE_ACELERACAO) - erro_corrigido) * GRAVIDADE;
+        bruto->aceleracao[i] = (int16_t)((buffer[i * 2] << 8) | buffer[i * 2 + 1]);
+        bruto->giro[i] = (int16_t)((buffer[8 + i * 2] << 8) | buffer[8 + i * 2 + 1]);
+    }
+}
+
+// Parado e nivelado, a leitura corrigida deve dar giro ~0 e aceleração
+// ~(0, 0, 1 g): as mesmas hipóteses de calibra_giroscopio/calibra_aceleracao
+bool mpu6500_verificar_calibracao(void) {
+    int32_t soma[6] = {0};
+    int validas = 0;
+
+    for (int i = 0; i < NUM_AMOSTRAS_VERIFICACAO; i++) {
+        uint8_t buffer[MPU6500_TAMANHO_RAJADA];
+        mpu6500_bruto_t bruto;
+        if (mpu6500_ler(0x3B, buffer, MPU6500_TAMANHO_RAJADA)) {
+            mpu6500_decodificar(buffer, &bruto);
+            for (int j = 0; j < 3; j++) {
+                soma[j] += bruto.aceleracao[j];
+                soma[3 + j] += bruto.giro[j];
+            }
+            validas++;
+        }
+        sleep_ms(2);
+    }
+    if (validas < NUM_AMOSTRAS_VERIFICACAO / 2) return false;
+
+    bool ok = true;
+    for (int j = 0; j < 3; j++) {
+        float acel = (soma[j] / (float)validas) / SENSIBILIDADE_ACELERACAO - erro_aceleracao[j];
+        if (j == 2) acel -= 1.0f;
+        float giro = (soma[3 + j] / (float)validas) / SENSIBILIDADE_GIRO - bias_giro[j];
+        printf("Verificação %c: acel %+.3f g, giro %+.2f °/s\n", 'X' + j, (double)acel, (double)giro);
+        if (fabsf(acel) > LIMITE_VERIFICACAO_ACEL_G || fabsf(giro) > LIMITE_VERIFICACAO_GIRO) ok = false;
     }
+    return ok;
+}
+
+
+bool AERO_RAM_FUNC(mpu6500_iniciar_leitura_dma)(void) {
+    return mpu6500_disponivel() &&
+           mpu6500_iniciar_rajada(0x3B, buffer_dma, MPU6500_TAMANHO_RAJADA);
+}
 
-    // Giroscópio
-    mpu6500_ler(0x43, buffer, 6);
+bool AERO_RAM_FUNC(mpu6500_concluir_leitura_dma)(mpu6500_bruto_t *bruto) {
+    if (!mpu6500_aguardar_rajada()) return false;
+    mpu6500_decodificar(buffer_dma, bruto);
+    return true;
+}
+
+// Leitura com filtro complementar
+void AERO_RAM_FUNC(leitura)(float bias_giro[3], float erro_aceleracao[3], float *theta, float *phi, float dt) {
+    uint8_t buffer[MPU6500_TAMANHO_RAJADA];
+    mpu6500_bruto_t bruto;
+
+    // Em caso de falha de barramento mantém a atitude anterior
+    if (!mpu6500_ler(0x3B, buffer, MPU6500_TAMANHO_RAJADA)) return;
+    mpu6500_decodificar(buffer, &bruto);
+    leitura_processar(&bruto, bias_giro, erro_aceleracao, theta, phi, dt);
+}
+
+void AERO_RAM_FUNC(leitura_processar)(const mpu6500_bruto_t *bruto, float bias_giro[3], float erro_aceleracao[3],
+                       float *theta, float *phi, float dt) {
+    mpu6500_amostra_t amostra;
+
+    // Offsets constantes, como no lote (o erro do acelerômetro é o desvio
+    // médio em repouso e não depende do sinal da leitura)
     for (int i = 0; i < 3; i++) {
-        giro_bruto[i] = (int16_t)((buffer[i * 2] << 8) | buffer[i * 2 + 1]);
-        giro[i] = (giro_bruto[i] / SENSIBILIDADE_GIRO) - bias_giro[i]; // °/s
+        amostra.aceleracao[i] = bruto->aceleracao[i] * ESCALA_ACELERACAO - erro_aceleracao[i] * GRAVIDADE;
+        amostra.giro[i] = bruto->giro[i] * ESCALA_GIRO - bias_giro[i];
     }
+    mpu6500_fundir(&amostra, theta, phi, dt);
+}
+
+void AERO_RAM_FUNC(mpu6500_fundir)(const mpu6500_amostra_t *amostra, float *theta, float *phi, float dt) {
+    const float *aceleracao = amostra->aceleracao;
+    const float *giro = amostra->giro;
 
     // Ângulos via acelerômetro (graus)
-    float theta_acc = atan2(aceleracao[0], sqrt(aceleracao[1]*aceleracao[1] + aceleracao[2]*aceleracao[2])) * (180.0 / M_PI);
-    float phi_acc   = atan2(aceleracao[1], sqrt(aceleracao[0]*aceleracao[0] + aceleracao[2]*aceleracao[2])) * (180.0 / M_PI);
+    float theta_acc = mat_atan2_graus(aceleracao[0], mat_sqrt(aceleracao[1]*aceleracao[1] + aceleracao[2]*aceleracao[2]));
+    float phi_acc   = mat_atan2_graus(aceleracao[1], mat_sqrt(aceleracao[0]*aceleracao[0] + aceleracao[2]*aceleracao[2]));
 
     // Integração giroscópio
     float theta_giro = *theta + giro[0] * dt;
     float phi_giro   = *phi   + giro[1] * dt;
 
-    // Filtro complementar
-    float alpha = 0.95; // mais responsivo
-    *theta = alpha * theta_giro + (1 - alpha) * theta_acc;
-    *phi   = alpha * phi_giro   + (1 - alpha) * phi_acc;
+    // Filtro complementar com constante de tempo fixa: alpha = 0.95 no laço
+    // original de ~25 ms, e o mesmo comportamento em qualquer taxa
+    float alpha = TAU_FILTRO_COMPLEMENTAR / (TAU_FILTRO_COMPLEMENTAR + dt);
+    *theta = alpha * theta_giro + (1.0f - alpha) * theta_acc;
+    *phi   = alpha * phi_giro   + (1.0f - alpha) * phi_acc;
 
     //printf("Atitude (Pitch θ): %.2f° | Bank Angle (Roll φ): %.2f°\n", *theta, *phi);
 }
+
+static inline uint32_t empacotar(int16_t baixo, int16_t alto) {
+    return (uint16_t)baixo | ((uint32_t)(uint16_t)alto << 16);
+}
+
+static inline int16_t saturar_16(int32_t v) {
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+void mpu6500_atualizar_offsets(void) {
+    int16_t offsets[6];
+    for (int i = 0; i < 3; i++) {
+        offsets[i] = saturar_16(lroundf(erro_aceleracao[i] * SENSIBILIDADE_ACELERACAO));
+        offsets[3 + i] = saturar_16(lroundf(bias_giro[i] * SENSIBILIDADE_GIRO));
+    }
+    for (int i = 0; i < 3; i++) {
+        offsets_empacotados[i] = empacotar(offsets[2 * i], offsets[2 * i + 1]);
+    }
+}
+
+// Big-endian do sensor para o little-endian do M33, duas metades por palavra
+static void AERO_RAM_FUNC(mpu6500_trocar_bytes_lote)(const uint32_t *origem, uint32_t *destino, uint16_t palavras) {
+    for (int i = 0; i < palavras; i++) {
+#if defined(__ARM_FEATURE_SIMD32)
+        destino[i] = __rev16(origem[i]);
+#else
+        uint32_t w = origem[i];
+        destino[i] = ((w & 0x00FF00FFu) << 8) | ((w >> 8) & 0x00FF00FFu);
+#endif
+    }
+}
+
+#if defined(__ARM_FEATURE_SIMD32)
+// Por amostra: 3 QSUB16 (offsets), 6 SMLAD (somas por eixo) e
+// SMUAD + SMLABB (|a|²), em vez de 6 subtrações e 10 acumulações escalares
+void AERO_RAM_FUNC(mpu6500_converter_lote)(const mpu6500_bruto_t *brutos, uint16_t n,
+                                           mpu6500_amostra_t *saida, mpu6500_acumulador_t *acumulador) {
+    const int16x2_t baixo = 0x00000001, alto = 0x00010000;
+    int32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0;
+    uint64_t quadrados = 0;
+
+    for (int k = 0; k < n; k++) {
+        mpu6500_bruto_t c;
+        c.palavras[0] = __qsub16(brutos[k].palavras[0], offsets_empacotados[0]);
+        c.palavras[1] = __qsub16(brutos[k].palavras[1], offsets_empacotados[1]);
+        c.palavras[2] = __qsub16(brutos[k].palavras[2], offsets_empacotados[2]);
+
+        if (acumulador) {
+            s0 = __smlad(c.palavras[0], baixo, s0);
+            s1 = __smlad(c.palavras[0], alto, s1);
+            s2 = __smlad(c.palavras[1], baixo, s2);
+            s3 = __smlad(c.palavras[1], alto, s3);
+            s4 = __smlad(c.palavras[2], baixo, s4);
+            s5 = __smlad(c.palavras[2], alto, s5);
+            quadrados += (uint32_t)__smlabb(c.palavras[1], c.palavras[1],
+                                            __smuad(c.palavras[0], c.palavras[0]));
+        }
+
+        for (int i = 0; i < 3; i++) {
+            saida[k].aceleracao[i] = c.aceleracao[i] * ESCALA_ACELERACAO;
+            saida[k].giro[i] = c.giro[i] * ESCALA_GIRO;
+        }
+    }
+
+    if (acumulador) {
+        acumulador->soma[0] += s0;
+        acumulador->soma[1] += s1;
+        acumulador->soma[2] += s2;
+        acumulador->soma[3] += s3;
+        acumulador->soma[4] += s4;
+        acumulador->soma[5] += s5;
+        acumulador->soma_quadrados_acel += quadrados;
+        acumulador->amostras += n;
+    }
+}
+#else
+void AERO_RAM_FUNC(mpu6500_converter_lote)(const mpu6500_bruto_t *brutos, uint16_t n,
+                                           mpu6500_amostra_t *saida, mpu6500_acumulador_t *acumulador) {
+    mpu6500_bruto_t offsets;
+    for (int i = 0; i < 3; i++) offsets.palavras[i] = offsets_empacotados[i];
+
+    for (int k = 0; k < n; k++) {
+        int16_t c[6];
+        for (int i = 0; i < 3; i++) {
+            c[i] = saturar_16(brutos[k].aceleracao[i] - offsets.aceleracao[i]);
+            c[3 + i] = saturar_16(brutos[k].giro[i] - offsets.giro[i]);
+        }
+
+        if (acumulador) {
+            for (int i = 0; i < 6; i++) acumulador->soma[i] += c[i];
+            // Cada quadrado cabe em int (<= 2^30), a soma dos três só em uint32_t
+            acumulador->soma_quadrados_acel += (uint32_t)(c[0] * c[0]) + (uint32_t)(c[1] * c[1]) +
+                                               (uint32_t)(c[2] * c[2]);
+        }
+
+        for (int i = 0; i < 3; i++) {
+            saida[k].aceleracao[i] = c[i] * ESCALA_ACELERACAO;
+            saida[k].giro[i] = c[3 + i] * ESCALA_GIRO;
+        }
+    }
+    if (acumulador) acumulador->amostras += n;
+}
+#endif
+
+#ifdef AERO_MATEMATICA_BENCHMARK
+// Lote cheio de dados pseudoaleatórios: caminho escalar anterior (bytes a
+// bytes e divisões por elemento) contra troca de bytes + converter_lote
+void mpu6500_benchmark_lote(void) {
+    static mpu6500_bruto_t brutos[MPU6500_LOTE_MAX];
+    static mpu6500_amostra_t lote[MPU6500_LOTE_MAX], escalar[MPU6500_LOTE_MAX];
+    mpu6500_acumulador_t acumulador = {0};
+    uint32_t semente = 1;
+
+    for (int i = 0; i < count_of(buffer_dma_palavras); i++) {
+        semente = semente * 1664525u + 1013904223u;
+        buffer_dma_palavras[i] = semente;
+    }
+
+    uint32_t inicio = desempenho_ciclos();
+    for (int k = 0; k < MPU6500_LOTE_MAX; k++) {
+        const uint8_t *p = &buffer_dma[k * MPU6500_BYTES_AMOSTRA_FIFO];
+        for (int i = 0; i < 3; i++) {
+            int16_t a = (int16_t)((p[i * 2] << 8) | p[i * 2 + 1]);
+            int16_t g = (int16_t)((p[6 + i * 2] << 8) | p[6 + i * 2 + 1]);
+            escalar[k].aceleracao[i] = ((a / SENSIBILIDADE_ACELERACAO) - erro_aceleracao[i]) * GRAVIDADE;
+            escalar[k].giro[i] = (g / SENSIBILIDADE_GIRO) - bias_giro[i];
+        }
+    }
+    uint32_t ciclos_escalar = desempenho_ciclos() - inicio;
+
+    inicio = desempenho_ciclos();
+    mpu6500_trocar_bytes_lote(buffer_dma_palavras, brutos[0].palavras, MPU6500_LOTE_MAX * 3);
+    mpu6500_converter_lote(brutos, MPU6500_LOTE_MAX, lote, &acumulador);
+    uint32_t ciclos_lote = desempenho_ciclos() - inicio;
+
+    // Diferença vem do offset arredondado para contagens inteiras
+    float erro = 0.0f;
+    for (int k = 0; k < MPU6500_LOTE_MAX; k++) {
+        for (int i = 0; i < 3; i++) {
+            erro = fmaxf(erro, fabsf(lote[k].aceleracao[i] - escalar[k].aceleracao[i]));
+            erro = fmaxf(erro, fabsf(lote[k].giro[i] - escalar[k].giro[i]));
+        }
+    }
+
+    printf("MATH|imu_lote|%.1f|%.1f|%.2e\n",
+           (double)((float)ciclos_lote / MPU6500_LOTE_MAX),
+           (double)((float)ciclos_escalar / MPU6500_LOTE_MAX), (double)erro);
+}
+#endif
@@ -3,28 +3,147 @@
 
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "barramento_i2c.h"
+#include "matematica_rapida.h"
+#ifdef AERO_MPU6500_SPI
+#include "hardware/spi.h"
+#endif
 
 // Definições do sensor
 #define I2C_PORT i2c1
 #define SDA_PIN 2
 #define SCL_PIN 3
 
+// Interface SPI (AERO_MPU6500_SPI)
+#define MPU6500_SPI_PORT spi1
+#define MPU6500_SPI_MISO_PIN 8
+#define MPU6500_SPI_CS_PIN 9
+#define MPU6500_SPI_SCK_PIN 10
+#define MPU6500_SPI_MOSI_PIN 11
+#define MPU6500_SPI_BAUD_CONFIG (1000 * 1000)   // Limite para registradores de configuração
+#define MPU6500_SPI_BAUD_DADOS (20 * 1000 * 1000) // Leitura de 0x3A..0x48 (sensor e interrupção)
+#define MPU6500_INT_PIN 14  // Saída INT (dado pronto) do sensor
+
 #define MPU6500_ENDERECO 0x68
-#define SENSIBILIDADE_GIRO 131.0        // ±250°/s
-#define SENSIBILIDADE_ACELERACAO 8192.0 // ±4g
-#define GRAVIDADE 9.81
+#define SENSIBILIDADE_GIRO 65.5f        // ±500°/s (GYRO_CONFIG = 0x08)
+#define SENSIBILIDADE_ACELERACAO 8192.0f // ±4g
 #define NUM_AMOSTRAS 1000
+#define NUM_AMOSTRAS_VERIFICACAO 50     // ~0,1 s
+#define LIMITE_VERIFICACAO_GIRO 0.5f    // °/s
+#define LIMITE_VERIFICACAO_ACEL_G 0.05f
+#define MPU6500_TIMEOUT_US 2000  // Rajada de 14 bytes a 400 kHz leva ~400 us
+#define MPU6500_TAMANHO_RAJADA 14  // 0x3B..0x48: aceleração, temperatura, giro
+#define TAU_FILTRO_COMPLEMENTAR 0.475f  // s
+
+// FIFO de hardware (512 bytes)
+#define MPU6500_TAMANHO_FIFO 512
+#define MPU6500_BYTES_AMOSTRA_FIFO 12  // Aceleração + giro, sem temperatura
+#define MPU6500_LOTE_MAX 16            // Amostras por leitura da FIFO
+#ifdef AERO_MPU6500_SPI
+#define MPU6500_TAXA_FIFO_HZ 1000
+#else
+#define MPU6500_TAXA_FIFO_HZ 500       // Limitada pelo tempo de barramento a 400 kHz
+#endif
+
+// Amostra bruta (contagens do ADC). Mesma ordem da FIFO; as 3 palavras
+// de 32 bits são usadas pelos núcleos SIMD de lote.
+typedef union {
+    struct {
+        int16_t aceleracao[3];
+        int16_t giro[3];
+    };
+    uint32_t palavras[3];
+} mpu6500_bruto_t;
+
+// Amostra em unidades físicas, já sem os offsets de calibração
+typedef struct {
+    float aceleracao[3];  // m/s²
+    float giro[3];        // °/s
+} mpu6500_amostra_t;
+
+// Somas de um lote em contagens, para médias e energia de vibração
+typedef struct {
+    int32_t soma[6];                 // aceleração XYZ, giro XYZ
+    uint64_t soma_quadrados_acel;    // Σ |a|²
+    uint32_t amostras;
+} mpu6500_acumulador_t;
+
+typedef struct {
+    uint32_t amostras;      // Amostras lidas da FIFO
+    uint32_t lotes;
+    uint32_t estouros;      // FIFO cheia (amostras perdidas) ou leitura falha
+    uint32_t interrupcoes;  // Pulsos de dado pronto no pino INT
+    uint64_t ultimo_int_us; // Instante do pulso mais recente
+} mpu6500_fifo_estatisticas_t;
+
+extern mpu6500_fifo_estatisticas_t mpu6500_fifo_stats;
 
 // Variáveis globais de calibração
 extern float bias_giro[3];
 extern float erro_aceleracao[3];
 
+#ifdef AERO_MPU6500_SPI
+typedef struct {
+    uint32_t transacoes;
+    uint32_t bytes;
+} mpu6500_spi_estatisticas_t;
+
+extern mpu6500_spi_estatisticas_t mpu6500_spi_stats;
+#else
+// Barramento do sensor (estatísticas de erro e latência)
+extern dispositivo_i2c_t mpu6500_i2c;
+#endif
+
 // Inicialização e calibração
 void mpu6500_inicializar();
+uint8_t mpu6500_ler_id(void);  // WHO_AM_I (0x70 no MPU6500, 0x68 no MPU6050)
 void calibra_giroscopio();
 void calibra_aceleracao();
 
+// Confere bias_giro/erro_aceleracao (ex.: lidos do flash) com ~0,1 s de
+// leituras do sensor parado; false se algum eixo sai dos limites
+bool mpu6500_verificar_calibracao(void);
+
+// Leitura assíncrona da rajada de 14 bytes: por DMA no i2c1, em paralelo com
+// o BME680 no i2c0; no SPI a leitura é feita já no início (~10 us)
+bool mpu6500_iniciar_leitura_dma(void);
+bool mpu6500_concluir_leitura_dma(mpu6500_bruto_t *bruto);
+
+// Modo FIFO: amostragem pelo relógio do sensor (SMPLRT_DIV) com interrupção
+// de dado pronto no MPU6500_INT_PIN. Chamar depois da calibração.
+bool mpu6500_configurar_fifo(uint16_t taxa_hz);
+uint16_t mpu6500_taxa_fifo(void);
+
+// FIFO|amostras|lotes|estouros|interrupcoes
+void mpu6500_imprimir_estatisticas_fifo(void);
+
+// Lote da FIFO em duas fases: iniciar lê FIFO_COUNT e dispara por DMA a
+// leitura de até MPU6500_LOTE_MAX amostras; concluir espera e decodifica.
+// Retornam o número de amostras (0 se nada disponível ou erro). tempo_us
+// recebe o instante (time_us_64) da primeira, pelo pulso de dado pronto da
+// mais nova na FIFO; as seguintes vêm a cada 1 / taxa.
+uint16_t mpu6500_iniciar_leitura_fifo(void);
+uint16_t mpu6500_concluir_leitura_fifo(mpu6500_bruto_t *amostras, uint64_t *tempo_us);
+
+// Núcleos de lote (SIMD de 16 bits do M33 quando disponível, C portátil
+// nos demais alvos). converter_lote subtrai os offsets de calibração com
+// saturação, acumula as somas em 'acumulador' (pode ser NULL; não é
+// zerado) e escala para unidades físicas.
+void mpu6500_atualizar_offsets(void);  // Depois de calibra_giroscopio/calibra_aceleracao
+void mpu6500_converter_lote(const mpu6500_bruto_t *brutos, uint16_t n,
+                            mpu6500_amostra_t *saida, mpu6500_acumulador_t *acumulador);
+
+// Filtro complementar sobre uma amostra convertida
+void mpu6500_fundir(const mpu6500_amostra_t *amostra, float *theta, float *phi, float dt);
+
+#ifdef AERO_MATEMATICA_BENCHMARK
+// MATH|imu_lote|ciclos_lote|ciclos_escalar|erro_max (por amostra)
+void mpu6500_benchmark_lote(void);
+#endif
+
 // Leitura com filtro complementar
 void leitura(float bias_giro[3], float erro_aceleracao[3], float *theta, float *phi, float dt);
+void leitura_processar(const mpu6500_bruto_t *bruto, float bias_giro[3], float erro_aceleracao[3],
+                       float *theta, float *phi, float dt);
 
 #endif
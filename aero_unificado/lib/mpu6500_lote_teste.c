@@ -0,0 +1,117 @@
+// Teste dos núcleos de lote do MPU6500 (troca de bytes e converter_lote)
+// contra uma referência escalar em int64: offsets com saturação, somas por
+// eixo, Σ |a|² e a conversão para unidades físicas. Os extremos de 16 bits
+// cobrem a saturação e o maior |a|² (3 · 2^30).
+//
+// No host, o caminho C portátil e o SIMD com os intrínsecos emulados em
+// lib/teste_host/arm_acle.h:
+//   gcc -O2 -DAERO_MPU6500_SPI -Ilib/teste_host -Ilib lib/mpu6500_lote_teste.c lib/matematica_rapida.c -lm
+//   gcc -O2 -DAERO_MPU6500_SPI -D__ARM_FEATURE_SIMD32=1 -Ilib/teste_host -Ilib lib/mpu6500_lote_teste.c lib/matematica_rapida.c -lm
+#include <string.h>
+#include "teste.h"
+#include "mpu6500.c"
+
+uint64_t teste_tempo_us = 0;
+m33_hw_t *m33_hw = NULL;
+
+// Barramento sem sensor: o teste só usa os núcleos
+void gpio_put(uint pino, bool valor) { (void)pino; (void)valor; }
+unsigned spi_init(spi_inst_t *spi, unsigned baudrate) { (void)spi; return baudrate; }
+unsigned spi_set_baudrate(spi_inst_t *spi, unsigned baudrate) { (void)spi; return baudrate; }
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *origem, size_t tamanho) {
+    (void)spi; (void)origem;
+    return (int)tamanho;
+}
+int spi_read_blocking(spi_inst_t *spi, uint8_t repetido, uint8_t *destino, size_t tamanho) {
+    (void)spi; (void)repetido;
+    memset(destino, 0, tamanho);
+    return (int)tamanho;
+}
+
+#define LOTES 64
+
+static int32_t saturar_referencia(int32_t v) {
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v);
+}
+
+static void testar_troca_bytes(void) {
+    const uint8_t sensor[12] = { 0x12, 0x34, 0x80, 0x00, 0x7F, 0xFF, 0xFF, 0xFF, 0x00, 0x01, 0xAB, 0xCD };
+    const int16_t esperado[6] = { 0x1234, INT16_MIN, INT16_MAX, -1, 1, (int16_t)0xABCD };
+    uint32_t origem[3];
+    mpu6500_bruto_t bruto;
+    memcpy(origem, sensor, sizeof(origem));
+
+    mpu6500_trocar_bytes_lote(origem, bruto.palavras, 3);
+    for (int i = 0; i < 3; i++) {
+        VERIFICAR(bruto.aceleracao[i] == esperado[i]);
+        VERIFICAR(bruto.giro[i] == esperado[3 + i]);
+    }
+}
+
+static void testar_converter_lote(void) {
+    // Offsets com sinais dos dois lados, para saturar nos dois extremos;
+    // X e Y positivos levam INT16_MIN a saturar nos dois: c0² + c1² = 2^31
+    erro_aceleracao[0] = 0.05f;
+    erro_aceleracao[1] = 0.03f;
+    erro_aceleracao[2] = -0.01f;
+    bias_giro[0] = -1.5f;
+    bias_giro[1] = 2.25f;
+    bias_giro[2] = 0.0f;
+    mpu6500_atualizar_offsets();
+
+    mpu6500_bruto_t offsets;
+    memcpy(offsets.palavras, offsets_empacotados, sizeof(offsets.palavras));
+
+    mpu6500_acumulador_t acumulador = { .soma = { 0 } };
+    int64_t soma[6] = { 0 };
+    uint64_t soma_quadrados = 0;
+    uint32_t semente = 7;
+
+    for (int lote = 0; lote < LOTES; lote++) {
+        mpu6500_bruto_t brutos[MPU6500_LOTE_MAX];
+        mpu6500_amostra_t saida[MPU6500_LOTE_MAX];
+        for (int k = 0; k < MPU6500_LOTE_MAX; k++) {
+            for (int i = 0; i < 3; i++) {
+                semente = semente * 1664525u + 1013904223u;
+                brutos[k].palavras[i] = semente;
+            }
+        }
+        // Extremos no primeiro lote
+        for (int i = 0; i < 3; i++) {
+            brutos[0].aceleracao[i] = brutos[0].giro[i] = INT16_MIN;
+            brutos[1].aceleracao[i] = brutos[1].giro[i] = INT16_MAX;
+        }
+
+        mpu6500_converter_lote(brutos, MPU6500_LOTE_MAX, saida, &acumulador);
+
+        for (int k = 0; k < MPU6500_LOTE_MAX; k++) {
+            int32_t c[6];
+            for (int i = 0; i < 3; i++) {
+                c[i] = saturar_referencia(brutos[k].aceleracao[i] - offsets.aceleracao[i]);
+                c[3 + i] = saturar_referencia(brutos[k].giro[i] - offsets.giro[i]);
+            }
+            for (int i = 0; i < 6; i++) soma[i] += c[i];
+            soma_quadrados += (uint64_t)((int64_t)c[0] * c[0] + (int64_t)c[1] * c[1] +
+                                         (int64_t)c[2] * c[2]);
+            for (int i = 0; i < 3; i++) {
+                VERIFICAR(saida[k].aceleracao[i] == (float)c[i] * ESCALA_ACELERACAO);
+                VERIFICAR(saida[k].giro[i] == (float)c[3 + i] * ESCALA_GIRO);
+            }
+        }
+    }
+
+    // Somas em int32 por lote não transbordam (16 · 2^15)
+    for (int i = 0; i < 6; i++) VERIFICAR(acumulador.soma[i] == soma[i]);
+    VERIFICAR(acumulador.soma_quadrados_acel == soma_quadrados);
+    VERIFICAR(acumulador.amostras == LOTES * MPU6500_LOTE_MAX);
+}
+
+int main(void) {
+    testar_troca_bytes();
+    testar_converter_lote();
+#if defined(__ARM_FEATURE_SIMD32)
+    return teste_resultado("mpu6500_lote_simd");
+#else
+    return teste_resultado("mpu6500_lote_c");
+#endif
+}
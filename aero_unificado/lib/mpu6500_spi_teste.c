@@ -0,0 +1,238 @@
+// Teste do backend SPI do MPU6500 contra um sensor simulado no lugar do
+// spi_write_blocking/spi_read_blocking: quadro (bit de leitura e endereço
+// com o CS baixo), clock por faixa de registradores, tamanho das rajadas e
+// decodificação da rajada de 14 bytes e do lote da FIFO.
+//
+// No host:
+//   gcc -O2 -DAERO_MPU6500_SPI -Ilib/teste_host -Ilib lib/mpu6500_spi_teste.c lib/matematica_rapida.c -lm
+#include <string.h>
+#include "teste.h"
+#include "mpu6500.c"
+
+uint64_t teste_tempo_us = 0;
+m33_hw_t *m33_hw = NULL;
+
+// Sensor simulado: banco de registradores com autoincremento e FIFO_R_W
+// (0x74) como fila de bytes
+static uint8_t registradores[128];
+static uint8_t fifo[MPU6500_TAMANHO_FIFO];
+static uint16_t fifo_lidos;
+
+static bool cs_baixo = false;
+static int cs_transicoes = 0;
+static bool endereco_pendente = false;
+static uint8_t endereco;
+static unsigned baud_atual = 0;
+
+// Último quadro completo
+typedef struct {
+    uint8_t endereco;    // Primeiro byte, com o bit de leitura
+    uint16_t dados;      // Bytes depois do endereço
+    unsigned baud;
+    bool repetido_zero;  // Leitura enviando 0x00
+} quadro_t;
+
+static quadro_t quadro, quadro_atual;
+
+// Pulso de dado pronto logo depois da leitura de FIFO_COUNT: a contagem
+// lida não inclui a amostra nova, mas o instante do pulso sim
+static bool pulso_na_leitura = false;
+static int leituras_contagem = 0;
+static uint8_t escrita_0x6A[8];
+static int escritas_0x6A = 0;
+
+void gpio_put(uint pino, bool valor) {
+    if (pino != MPU6500_SPI_CS_PIN) return;
+    if (!valor && !cs_baixo) {
+        endereco_pendente = true;
+        memset(&quadro_atual, 0, sizeof(quadro_atual));
+        quadro_atual.repetido_zero = true;
+    } else if (valor && cs_baixo) {
+        quadro = quadro_atual;
+    }
+    if (valor != !cs_baixo) cs_transicoes++;
+    cs_baixo = !valor;
+}
+
+unsigned spi_init(spi_inst_t *spi, unsigned baudrate) {
+    (void)spi;
+    return baud_atual = baudrate;
+}
+
+unsigned spi_set_baudrate(spi_inst_t *spi, unsigned baudrate) {
+    (void)spi;
+    return baud_atual = baudrate;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *origem, size_t tamanho) {
+    VERIFICAR(spi == MPU6500_SPI_PORT);
+    VERIFICAR(cs_baixo);
+    for (size_t i = 0; i < tamanho; i++) {
+        if (endereco_pendente) {
+            endereco = origem[i];
+            quadro_atual.endereco = origem[i];
+            quadro_atual.baud = baud_atual;
+            endereco_pendente = false;
+            continue;
+        }
+        VERIFICAR(!(endereco & 0x80));  // Dados só seguem endereço de escrita
+        uint8_t reg = endereco & 0x7F;
+        registradores[reg] = origem[i];
+        if (reg == 0x6A && escritas_0x6A < (int)count_of(escrita_0x6A)) {
+            escrita_0x6A[escritas_0x6A++] = origem[i];
+        }
+        endereco++;
+        quadro_atual.dados++;
+    }
+    return (int)tamanho;
+}
+
+int spi_read_blocking(spi_inst_t *spi, uint8_t repetido, uint8_t *destino, size_t tamanho) {
+    VERIFICAR(spi == MPU6500_SPI_PORT);
+    VERIFICAR(cs_baixo);
+    VERIFICAR(!endereco_pendente);
+    VERIFICAR(endereco & 0x80);
+    if (repetido != 0x00) quadro_atual.repetido_zero = false;
+    bool contagem = (endereco & 0x7F) == 0x72;
+    for (size_t i = 0; i < tamanho; i++) {
+        uint8_t reg = endereco & 0x7F;
+        if (reg == 0x74) {
+            destino[i] = fifo[fifo_lidos++];
+        } else {
+            destino[i] = registradores[reg];
+            endereco++;
+        }
+        quadro_atual.dados++;
+    }
+    if (contagem) {
+        leituras_contagem++;
+        if (pulso_na_leitura) {
+            pulso_na_leitura = false;
+            uint16_t bytes = ((registradores[0x72] << 8) | registradores[0x73]) + MPU6500_BYTES_AMOSTRA_FIFO;
+            registradores[0x72] = (uint8_t)(bytes >> 8);
+            registradores[0x73] = (uint8_t)bytes;
+            ultimo_int_us += 1000000u / taxa_fifo_hz;
+            interrupcoes_int++;
+        }
+    }
+    return (int)tamanho;
+}
+
+static void escrever_16(uint8_t *p, int16_t v) {
+    p[0] = (uint8_t)((uint16_t)v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static void testar_escrita(void) {
+    mpu6500_barramento_inicializar();
+    cs_transicoes = 0;
+    mpu6500_escrever(0x1B, 0x08);
+
+    VERIFICAR(quadro.endereco == 0x1B);  // Bit 7 em 0: escrita
+    VERIFICAR(quadro.dados == 1);
+    VERIFICAR(registradores[0x1B] == 0x08);
+    VERIFICAR(quadro.baud == MPU6500_SPI_BAUD_CONFIG);
+    VERIFICAR(cs_transicoes == 2 && !cs_baixo);
+}
+
+static void testar_leitura_configuracao(void) {
+    registradores[0x75] = 0x70;
+    VERIFICAR(mpu6500_ler_id() == 0x70);
+    VERIFICAR(quadro.endereco == (0x75 | 0x80));
+    VERIFICAR(quadro.dados == 1);
+    VERIFICAR(quadro.repetido_zero);
+    VERIFICAR(quadro.baud == MPU6500_SPI_BAUD_CONFIG);  // Fora da faixa de dados
+}
+
+static void testar_rajada(void) {
+    const int16_t aceleracao[3] = { 1234, -8192, INT16_MIN };
+    const int16_t giro[3] = { -1, INT16_MAX, 655 };
+    for (int i = 0; i < 3; i++) {
+        escrever_16(&registradores[0x3B + 2 * i], aceleracao[i]);
+        escrever_16(&registradores[0x43 + 2 * i], giro[i]);
+    }
+    escrever_16(&registradores[0x41], 0x5A5A);  // Temperatura, descartada
+
+    mpu6500_bruto_t bruto;
+    memset(&bruto, 0, sizeof(bruto));
+    VERIFICAR(mpu6500_iniciar_leitura_dma());
+    VERIFICAR(mpu6500_concluir_leitura_dma(&bruto));
+
+    VERIFICAR(quadro.endereco == (0x3B | 0x80));
+    VERIFICAR(quadro.dados == MPU6500_TAMANHO_RAJADA);
+    VERIFICAR(quadro.baud == MPU6500_SPI_BAUD_DADOS);
+    for (int i = 0; i < 3; i++) {
+        VERIFICAR(bruto.aceleracao[i] == aceleracao[i]);
+        VERIFICAR(bruto.giro[i] == giro[i]);
+    }
+}
+
+// Lote maior que MPU6500_LOTE_MAX: a rajada para no máximo, a ordem das
+// amostras e de cada eixo é a da FIFO, e o instante da primeira vem do
+// último pulso recuado pelas amostras à frente dela na FIFO
+static void testar_fifo(void) {
+    const int disponiveis = MPU6500_LOTE_MAX + 3;
+    taxa_fifo_hz = MPU6500_TAXA_FIFO_HZ;
+    uint32_t periodo_us = 1000000u / taxa_fifo_hz;
+    interrupcoes_int = 100;
+    ultimo_int_us = 5000000;
+    for (int k = 0; k < disponiveis; k++) {
+        for (int i = 0; i < 6; i++) {
+            escrever_16(&fifo[k * MPU6500_BYTES_AMOSTRA_FIFO + 2 * i], (int16_t)(k * 100 - i * 7));
+        }
+    }
+    fifo_lidos = 0;
+    uint16_t bytes = disponiveis * MPU6500_BYTES_AMOSTRA_FIFO;
+    registradores[0x72] = (uint8_t)(bytes >> 8);
+    registradores[0x73] = (uint8_t)bytes;
+
+    mpu6500_bruto_t lote[MPU6500_LOTE_MAX];
+    uint64_t tempo_us = 0;
+    leituras_contagem = 0;
+    VERIFICAR(mpu6500_iniciar_leitura_fifo() == MPU6500_LOTE_MAX);
+    VERIFICAR(leituras_contagem == 1);
+    VERIFICAR(quadro.endereco == (0x74 | 0x80));
+    VERIFICAR(quadro.dados == MPU6500_LOTE_MAX * MPU6500_BYTES_AMOSTRA_FIFO);
+    VERIFICAR(quadro.baud == MPU6500_SPI_BAUD_CONFIG);  // FIFO_R_W fora de 0x3A..0x48
+    VERIFICAR(mpu6500_concluir_leitura_fifo(lote, &tempo_us) == MPU6500_LOTE_MAX);
+    VERIFICAR(tempo_us == 5000000 - (uint64_t)(disponiveis - 1) * periodo_us);
+
+    for (int k = 0; k < MPU6500_LOTE_MAX; k++) {
+        for (int i = 0; i < 3; i++) {
+            VERIFICAR(lote[k].aceleracao[i] == (int16_t)(k * 100 - i * 7));
+            VERIFICAR(lote[k].giro[i] == (int16_t)(k * 100 - (3 + i) * 7));
+        }
+    }
+
+    // Pulso durante a leitura da contagem: lida de novo, e a primeira
+    // amostra continua no mesmo instante
+    fifo_lidos = 0;
+    pulso_na_leitura = true;
+    leituras_contagem = 0;
+    VERIFICAR(mpu6500_iniciar_leitura_fifo() == MPU6500_LOTE_MAX);
+    VERIFICAR(leituras_contagem == 2);
+    VERIFICAR(mpu6500_concluir_leitura_fifo(lote, &tempo_us) == MPU6500_LOTE_MAX);
+    VERIFICAR(tempo_us == 5000000 - (uint64_t)(disponiveis - 1) * periodo_us);
+}
+
+// FIFO cheia: lote descartado e FIFO_RST com FIFO_EN e I2C_IF_DIS
+static void testar_fifo_estouro(void) {
+    registradores[0x72] = MPU6500_TAMANHO_FIFO >> 8;
+    registradores[0x73] = MPU6500_TAMANHO_FIFO & 0xFF;
+    uint32_t estouros = mpu6500_fifo_stats.estouros;
+    escritas_0x6A = 0;
+
+    VERIFICAR(mpu6500_iniciar_leitura_fifo() == 0);
+    VERIFICAR(mpu6500_fifo_stats.estouros == estouros + 1);
+    VERIFICAR(escritas_0x6A == 1 && escrita_0x6A[0] == (0x10 | 0x40 | 0x04));
+    VERIFICAR(quadro.baud == MPU6500_SPI_BAUD_CONFIG);
+}
+
+int main(void) {
+    testar_escrita();
+    testar_leitura_configuracao();
+    testar_rajada();
+    testar_fifo();
+    testar_fifo_estouro();
+    return teste_resultado("mpu6500_spi");
+}
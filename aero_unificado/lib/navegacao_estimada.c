@@ -0,0 +1,39 @@
+#include "navegacao_estimada.h"
+#include <string.h>
+#include "matematica_rapida.h"
+
+void nav_estimada_inicializar(navegacao_estimada_t *nav) {
+    memset(nav, 0, sizeof(*nav));
+    nav->cosseno_eixo = 1.0f;
+}
+
+void nav_estimada_corrigir(navegacao_estimada_t *nav, float leste, float norte,
+                           float velocidade, float rumo_graus, float guinada_graus) {
+    float seno, cosseno;
+    mat_sen_cos_graus(rumo_graus, &seno, &cosseno);
+    nav->posicao[0] = leste;
+    nav->posicao[1] = norte;
+    nav->velocidade[0] = velocidade * seno;
+    nav->velocidade[1] = velocidade * cosseno;
+
+    // A guinada cresce no sentido anti-horário e o rumo no horário: o eixo
+    // x da AHRS aponta para rumo + guinada
+    mat_sen_cos_graus(rumo_graus + guinada_graus, &nav->seno_eixo, &nav->cosseno_eixo);
+
+    nav->tempo_desde_fix = 0.0f;
+    nav->valida = true;
+    nav->fixes++;
+}
+
+void nav_estimada_propagar(navegacao_estimada_t *nav, const float aceleracao[2], float dt) {
+    if (!nav->valida || nav->tempo_desde_fix > NAV_TEMPO_MAX_S) return;
+    nav->tempo_desde_fix += dt;
+
+    float leste = aceleracao[0] * nav->seno_eixo - aceleracao[1] * nav->cosseno_eixo;
+    float norte = aceleracao[0] * nav->cosseno_eixo + aceleracao[1] * nav->seno_eixo;
+
+    nav->posicao[0] += (nav->velocidade[0] + 0.5f * leste * dt) * dt;
+    nav->posicao[1] += (nav->velocidade[1] + 0.5f * norte * dt) * dt;
+    nav->velocidade[0] += leste * dt;
+    nav->velocidade[1] += norte * dt;
+}
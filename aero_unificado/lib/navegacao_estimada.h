@@ -0,0 +1,37 @@
+#ifndef NAVEGACAO_ESTIMADA_H
+#define NAVEGACAO_ESTIMADA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Navegação estimada entre os fixes de 1 Hz do RMC: posição e velocidade
+// horizontais propagadas na taxa da telemetria com a aceleração da IMU no
+// referencial da Terra da AHRS. A cada fix a posição volta para a do GPS
+// e a velocidade para a do RMC (módulo e rumo).
+//
+// A AHRS não observa o norte: no fix, o rumo do RMC é tomado como a
+// direção do eixo x do sensor (sem derrapagem nem deriva de vento), o que
+// amarra a guinada da AHRS a Leste/Norte até o fix seguinte.
+#define NAV_TEMPO_MAX_S 3.0f   // Sem fix por mais tempo: a posição congela
+
+typedef struct {
+    float posicao[2];     // Leste, Norte (m, mesma origem do GPS)
+    float velocidade[2];  // m/s
+    float seno_eixo;      // Rumo do eixo x do referencial da AHRS
+    float cosseno_eixo;
+    float tempo_desde_fix;
+    bool valida;
+    uint32_t fixes;
+} navegacao_estimada_t;
+
+void nav_estimada_inicializar(navegacao_estimada_t *nav);
+
+// Fix novo: posição em metros, velocidade em m/s, rumo em graus (horário a
+// partir do norte) e a guinada da AHRS no mesmo instante
+void nav_estimada_corrigir(navegacao_estimada_t *nav, float leste, float norte,
+                           float velocidade, float rumo_graus, float guinada_graus);
+
+// Aceleração horizontal no referencial da Terra da AHRS (x, y; m/s²)
+void nav_estimada_propagar(navegacao_estimada_t *nav, const float aceleracao[2], float dt);
+
+#endif
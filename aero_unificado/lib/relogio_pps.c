@@ -0,0 +1,100 @@
+#include "relogio_pps.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define US_POR_S 1000000.0
+#define SEGUNDOS_POR_DIA 86400
+
+void relogio_pps_inicializar(relogio_pps_t *relogio) {
+    memset(relogio, 0, sizeof(*relogio));
+    relogio->periodo_us = US_POR_S;
+}
+
+// Recomeça a aquisição com este pulso como referência; o pulso seguinte
+// mede o período de novo (o cristal pode ter derivado durante a perda)
+static void readquirir(relogio_pps_t *relogio, uint64_t pulso_us, uint32_t segundo_utc) {
+    relogio->travado = false;
+    relogio->referenciado = true;
+    relogio->segundo_ref = segundo_utc;
+    relogio->pulso_ref_us = (double)pulso_us;
+    relogio->seguidos = 0;
+    relogio->rejeicoes_seguidas = 0;
+}
+
+void relogio_pps_pulso(relogio_pps_t *relogio, uint64_t pulso_us, uint32_t segundo_utc) {
+    relogio->pulsos++;
+    if (!relogio->referenciado) {
+        readquirir(relogio, pulso_us, segundo_utc);
+        return;
+    }
+
+    // Segundos UTC desde o pulso de referência (pulsos perdidos, virada do dia)
+    int32_t segundos = (int32_t)segundo_utc - (int32_t)relogio->segundo_ref;
+    if (segundos < 0) segundos += SEGUNDOS_POR_DIA;
+    if (segundos == 0 || segundos > RELOGIO_PPS_HOLDOVER_S) {
+        readquirir(relogio, pulso_us, segundo_utc);
+        return;
+    }
+
+    double previsto = relogio->pulso_ref_us + segundos * relogio->periodo_us;
+    double erro = (double)pulso_us - previsto;
+
+    // Antes do primeiro período medido, o erro é a própria deriva acumulada:
+    // o segundo pulso mede o período direto
+    if (relogio->seguidos == 0 && !relogio->travado) {
+        double periodo = ((double)pulso_us - relogio->pulso_ref_us) / segundos;
+        if (fabs(periodo - US_POR_S) < RELOGIO_PPS_PORTA_US) {
+            relogio->periodo_us = periodo;
+            relogio->pulso_ref_us = (double)pulso_us;
+            relogio->segundo_ref = segundo_utc;
+            relogio->residuo_us = 0.0;
+            relogio->seguidos = 1;
+        } else {
+            relogio->rejeitados++;
+            readquirir(relogio, pulso_us, segundo_utc);
+        }
+        return;
+    }
+
+    if (fabs(erro) > RELOGIO_PPS_PORTA_US) {
+        relogio->rejeitados++;
+        if (++relogio->rejeicoes_seguidas >= RELOGIO_PPS_REJEICOES_MAX) {
+            readquirir(relogio, pulso_us, segundo_utc);
+        }
+        return;
+    }
+
+    // PI: a fase absorve parte do erro, a frequência integra o restante
+    relogio->pulso_ref_us = previsto + RELOGIO_PPS_KP * erro;
+    relogio->periodo_us += RELOGIO_PPS_KI * erro / segundos;
+    relogio->segundo_ref = segundo_utc;
+    relogio->residuo_us = erro;
+    relogio->residuo_quadratico += 0.1 * (erro * erro - relogio->residuo_quadratico);
+    relogio->rejeicoes_seguidas = 0;
+    if (++relogio->seguidos >= RELOGIO_PPS_PULSOS_TRAVA) relogio->travado = true;
+}
+
+bool relogio_pps_utc_us(const relogio_pps_t *relogio, uint64_t tempo_us, uint64_t *utc_us) {
+    if (!relogio->travado) return false;
+    double decorrido = ((double)tempo_us - relogio->pulso_ref_us) * (US_POR_S / relogio->periodo_us);
+    if (fabs(decorrido) > RELOGIO_PPS_HOLDOVER_S * US_POR_S) return false;
+
+    const int64_t us_por_dia = (int64_t)SEGUNDOS_POR_DIA * 1000000;
+    int64_t utc = (int64_t)relogio->segundo_ref * 1000000 + (int64_t)floor(decorrido);
+    utc %= us_por_dia;
+    if (utc < 0) utc += us_por_dia;
+    *utc_us = (uint64_t)utc;
+    return true;
+}
+
+double relogio_pps_deriva_ppm(const relogio_pps_t *relogio) {
+    return relogio->periodo_us - US_POR_S;
+}
+
+void relogio_pps_imprimir_estatisticas(const relogio_pps_t *relogio) {
+    printf("PPS|%d|%lu|%lu|%.3f|%.2f|%.2f\n", relogio->travado,
+           (unsigned long)relogio->pulsos, (unsigned long)relogio->rejeitados,
+           relogio_pps_deriva_ppm(relogio), relogio->residuo_us,
+           sqrt(relogio->residuo_quadratico));
+}
@@ -0,0 +1,51 @@
+#ifndef RELOGIO_PPS_H
+#define RELOGIO_PPS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Relógio do Pico disciplinado pelo pulso por segundo (timepulse) do
+// NEO-6: cada borda capturada em time_us_64 é casada com o segundo UTC do
+// RMC seguinte, e um servo PI de fase e frequência estima o instante do
+// Pico de cada segundo UTC e o período do cristal (µs do Pico por segundo
+// UTC). Entre pulsos, e por até RELOGIO_PPS_HOLDOVER_S sem eles, o
+// instante UTC sai da reta estimada.
+//
+// Laço de 2ª ordem com polos em ~0,84 por pulso: converge em ~6 s e
+// filtra o jitter de captura da interrupção.
+#define RELOGIO_PPS_KP 0.3
+#define RELOGIO_PPS_KI 0.03
+#define RELOGIO_PPS_PORTA_US 500.0    // Erro de fase acima disso: pulso rejeitado
+#define RELOGIO_PPS_REJEICOES_MAX 3   // Rejeições seguidas: readquire
+#define RELOGIO_PPS_PULSOS_TRAVA 4    // Pulsos seguidos dentro da porta para travar
+#define RELOGIO_PPS_HOLDOVER_S 60     // Sem pulsos por mais tempo: destrava
+
+typedef struct {
+    bool travado;
+    bool referenciado;       // Já há um pulso de referência
+    uint32_t segundo_ref;    // Segundo UTC do dia do último pulso aceito
+    double pulso_ref_us;     // Instante estimado do Pico nesse segundo
+    double periodo_us;       // µs do Pico por segundo UTC
+    double residuo_us;       // Último erro de fase (medido - previsto)
+    double residuo_quadratico;  // Média exponencial do quadrado do residuo
+    uint32_t seguidos;       // Pulsos seguidos dentro da porta
+    uint32_t rejeicoes_seguidas;
+    uint32_t pulsos;
+    uint32_t rejeitados;
+} relogio_pps_t;
+
+void relogio_pps_inicializar(relogio_pps_t *relogio);
+
+// Borda do pulso em time_us_64 e o segundo UTC do dia (0..86399) que ela marca
+void relogio_pps_pulso(relogio_pps_t *relogio, uint64_t pulso_us, uint32_t segundo_utc);
+
+// µs desde 0h UTC no instante tempo_us do Pico; false se não travado
+bool relogio_pps_utc_us(const relogio_pps_t *relogio, uint64_t tempo_us, uint64_t *utc_us);
+
+// Deriva do cristal do Pico em ppm (positiva: o Pico adianta)
+double relogio_pps_deriva_ppm(const relogio_pps_t *relogio);
+
+// PPS|travado|pulsos|rejeitados|deriva_ppm|residuo_us|residuo_rms_us
+void relogio_pps_imprimir_estatisticas(const relogio_pps_t *relogio);
+
+#endif
@@ -0,0 +1,124 @@
+// Teste do relógio disciplinado pelo PPS contra um Pico simulado com o
+// cristal adiantado 25 ppm e ±1 µs de jitter de captura, começando perto
+// da meia-noite UTC: deriva estimada, erro do instante UTC no meio de
+// cada segundo (também durante pulsos perdidos e depois da virada do
+// dia), borda espúria rejeitada pela porta, readquisição depois de um
+// salto de fase e perda da trava após o holdover.
+//
+// No host:
+//   gcc -O2 -Ilib/teste_host -Ilib lib/relogio_pps_teste.c lib/relogio_pps.c -lm
+#include <math.h>
+#include "teste.h"
+#include "relogio_pps.h"
+
+#define DERIVA_PPM 25.0
+#define PERIODO_US (1e6 * (1.0 + DERIVA_PPM * 1e-6))
+#define INICIO_US 12345678.0
+#define SEGUNDO_INICIAL 86300     // 0h UTC no pulso 100
+#define PULSOS 240
+#define ERRO_MAX_US 5.0
+
+static relogio_pps_t relogio;
+static double fase_us = 0.0;      // Saltos de fase do receptor
+
+// LCG: a mesma sequência de jitter em qualquer host
+static uint32_t semente = 12345;
+
+static double jitter_us(void) {
+    semente = semente * 1664525u + 1013904223u;
+    return (semente >> 8) / 8388608.0 - 1.0;
+}
+
+// Instante do Pico do pulso k (sem jitter) e o segundo UTC que ele marca
+static double instante_pulso(int k) {
+    return INICIO_US + k * PERIODO_US + fase_us;
+}
+
+static uint32_t segundo_pulso(int k) {
+    return (SEGUNDO_INICIAL + k) % 86400;
+}
+
+// Erro do UTC no meio do segundo seguinte ao pulso k
+static double erro_utc_us(int k) {
+    uint64_t utc_us;
+    if (!relogio_pps_utc_us(&relogio, (uint64_t)llround(instante_pulso(k) + 0.5 * PERIODO_US), &utc_us)) {
+        return INFINITY;
+    }
+    double esperado = segundo_pulso(k) * 1e6 + 0.5e6;
+    double erro = (double)utc_us - esperado;
+    // Perto da virada o erro pode dar a volta no dia
+    if (erro > 43200e6) erro -= 86400e6;
+    if (erro < -43200e6) erro += 86400e6;
+    return erro;
+}
+
+static void pulso(int k, double desvio_us) {
+    relogio_pps_pulso(&relogio, (uint64_t)llround(instante_pulso(k) + jitter_us() + desvio_us), segundo_pulso(k));
+}
+
+int main(void) {
+    relogio_pps_inicializar(&relogio);
+    double erro_max = 0.0;
+    uint32_t rejeitados;
+
+    for (int k = 0; k < PULSOS; k++) {
+        // Pulsos perdidos, um deles na virada do dia: a reta segue no holdover
+        if (k == 50 || k == 51 || k == 52 || k == 100) {
+            VERIFICAR(fabs(erro_utc_us(k)) < ERRO_MAX_US);
+            continue;
+        }
+
+        // Borda espúria 3 ms depois da real, casada com o segundo no lugar dela
+        if (k == 80) {
+            rejeitados = relogio.rejeitados;
+            pulso(k, 3000.0);
+            VERIFICAR(relogio.rejeitados == rejeitados + 1);
+            VERIFICAR(relogio.travado);
+            continue;
+        }
+
+        // Salto de fase de 2 ms (receptor reiniciado): três rejeições e
+        // readquisição; o período é medido de novo no pulso seguinte
+        if (k == 150) fase_us = 2000.0;
+
+        pulso(k, 0.0);
+        if (k == 150 || k == 151) {
+            // Ainda na reta antiga: o pulso chega 2 ms depois, o UTC sai 2 ms adiantado
+            VERIFICAR(relogio.travado);
+            VERIFICAR_PROXIMO(erro_utc_us(k), 2000.0, ERRO_MAX_US);
+            continue;
+        }
+        if (k == 152) {
+            VERIFICAR(!relogio.travado);
+            VERIFICAR(relogio.seguidos == 0);
+        }
+
+        if (k >= 10 && relogio.travado) {
+            double erro = fabs(erro_utc_us(k));
+            if (erro > erro_max) erro_max = erro;
+            VERIFICAR(erro < ERRO_MAX_US);
+        }
+    }
+
+    relogio_pps_imprimir_estatisticas(&relogio);
+    printf("PPS|erro_utc_max %.2f us\n", erro_max);
+
+    VERIFICAR(relogio.travado);
+    VERIFICAR_PROXIMO(relogio_pps_deriva_ppm(&relogio), DERIVA_PPM, 0.5);
+    VERIFICAR(relogio.rejeitados == 4);  // A borda espúria e o salto de fase
+    VERIFICAR(fabs(erro_utc_us(PULSOS - 1)) < ERRO_MAX_US);
+
+    // Holdover: a reta vale por RELOGIO_PPS_HOLDOVER_S sem pulsos
+    VERIFICAR(fabs(erro_utc_us(PULSOS - 1 + RELOGIO_PPS_HOLDOVER_S - 2)) < 100.0);
+    VERIFICAR(isinf(erro_utc_us(PULSOS - 1 + RELOGIO_PPS_HOLDOVER_S + 1)));
+
+    // Volta depois do holdover: readquire do zero e trava de novo
+    int k = PULSOS + 2 * RELOGIO_PPS_HOLDOVER_S;
+    pulso(k, 0.0);
+    VERIFICAR(!relogio.travado);
+    for (int i = 1; i <= RELOGIO_PPS_PULSOS_TRAVA; i++) pulso(k + i, 0.0);
+    VERIFICAR(relogio.travado);
+    VERIFICAR(fabs(erro_utc_us(k + RELOGIO_PPS_PULSOS_TRAVA)) < ERRO_MAX_US);
+
+    return teste_resultado("relogio_pps");
+}
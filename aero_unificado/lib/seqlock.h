@@ -0,0 +1,34 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Seqlock de um produtor e vários leitores, sem travas, para passar um
+// instantâneo de estrutura entre núcleos. O escritor nunca espera; o
+// leitor repete a cópia se ela cruzou uma escrita.
+typedef struct {
+    volatile uint32_t sequencia;  // Ímpar durante a escrita
+} seqlock_t;
+
+static inline void seqlock_publicar(seqlock_t *sl, void *destino, const void *origem, size_t tamanho) {
+    sl->sequencia++;
+    __dmb();
+    memcpy(destino, origem, tamanho);
+    __dmb();
+    sl->sequencia++;
+}
+
+static inline void seqlock_ler(const seqlock_t *sl, void *destino, const void *origem, size_t tamanho) {
+    uint32_t inicio, fim;
+    do {
+        inicio = sl->sequencia;
+        __dmb();
+        memcpy(destino, origem, tamanho);
+        __dmb();
+        fim = sl->sequencia;
+    } while ((inicio & 1u) || inicio != fim);
+}
+
+#endif
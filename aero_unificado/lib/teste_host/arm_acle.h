@@ -0,0 +1,44 @@
+#ifndef TESTE_HOST_ARM_ACLE_H
+#define TESTE_HOST_ARM_ACLE_H
+
+// Intrínsecos SIMD de 16 bits do M33 emulados em C, com a semântica do
+// ARMv8-M (saturação do QSUB16, somas módulo 2^32 do SMLAD/SMUAD), para
+// compilar no host o caminho __ARM_FEATURE_SIMD32 dos núcleos de lote.
+#include <stdint.h>
+
+typedef int32_t int16x2_t;
+
+static inline int16_t acle_baixo(uint32_t x) { return (int16_t)(x & 0xFFFF); }
+static inline int16_t acle_alto(uint32_t x) { return (int16_t)(x >> 16); }
+
+static inline int16_t acle_saturar(int32_t v) {
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+static inline uint32_t acle_juntar(int16_t baixo, int16_t alto) {
+    return (uint16_t)baixo | ((uint32_t)(uint16_t)alto << 16);
+}
+
+static inline uint32_t __rev16(uint32_t x) {
+    return ((x & 0x00FF00FFu) << 8) | ((x >> 8) & 0x00FF00FFu);
+}
+
+static inline int16x2_t __qsub16(int16x2_t a, int16x2_t b) {
+    return (int16x2_t)acle_juntar(acle_saturar(acle_baixo(a) - acle_baixo(b)),
+                                  acle_saturar(acle_alto(a) - acle_alto(b)));
+}
+
+static inline int32_t __smuad(int16x2_t a, int16x2_t b) {
+    return (int32_t)((uint32_t)(acle_baixo(a) * acle_baixo(b)) +
+                     (uint32_t)(acle_alto(a) * acle_alto(b)));
+}
+
+static inline int32_t __smlad(int16x2_t a, int16x2_t b, int32_t acc) {
+    return (int32_t)((uint32_t)__smuad(a, b) + (uint32_t)acc);
+}
+
+static inline int32_t __smlabb(int32_t a, int32_t b, int32_t acc) {
+    return (int32_t)((uint32_t)(acle_baixo(a) * acle_baixo(b)) + (uint32_t)acc);
+}
+
+#endif
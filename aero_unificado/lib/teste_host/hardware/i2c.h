@@ -0,0 +1,7 @@
+#ifndef TESTE_HOST_HARDWARE_I2C_H
+#define TESTE_HOST_HARDWARE_I2C_H
+
+// Só os tipos: os testes usam os backends SPI
+typedef struct i2c_inst i2c_inst_t;
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef TESTE_HOST_HARDWARE_SPI_H
+#define TESTE_HOST_HARDWARE_SPI_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct spi_inst spi_inst_t;
+#define spi0 ((spi_inst_t *)0)
+#define spi1 ((spi_inst_t *)1)
+
+typedef enum { SPI_CPOL_0, SPI_CPOL_1 } spi_cpol_t;
+typedef enum { SPI_CPHA_0, SPI_CPHA_1 } spi_cpha_t;
+typedef enum { SPI_LSB_FIRST, SPI_MSB_FIRST } spi_order_t;
+
+static inline void spi_set_format(spi_inst_t *spi, unsigned bits, spi_cpol_t cpol,
+                                  spi_cpha_t cpha, spi_order_t ordem) {
+    (void)spi; (void)bits; (void)cpol; (void)cpha; (void)ordem;
+}
+
+// Transferências e clock: simulados pelo teste
+unsigned spi_init(spi_inst_t *spi, unsigned baudrate);
+unsigned spi_set_baudrate(spi_inst_t *spi, unsigned baudrate);
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *origem, size_t tamanho);
+int spi_read_blocking(spi_inst_t *spi, uint8_t repetido, uint8_t *destino, size_t tamanho);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef TESTE_HOST_HARDWARE_STRUCTS_M33_H
+#define TESTE_HOST_HARDWARE_STRUCTS_M33_H
+
+#include <stdint.h>
+
+typedef struct {
+    volatile uint32_t dwt_cyccnt;
+} m33_hw_t;
+
+extern m33_hw_t *m33_hw;
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef TESTE_HOST_PICO_STDLIB_H
+#define TESTE_HOST_PICO_STDLIB_H
+
+// SDK mínimo para compilar os drivers no host (testes em lib/*_teste.c):
+// GPIO, tempo e IRQ sem efeito; o barramento fica a cargo de cada teste.
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define __not_in_flash_func(nome) nome
+
+#define GPIO_IN 0
+#define GPIO_OUT 1
+#define GPIO_IRQ_EDGE_RISE 0x8u
+enum gpio_function { GPIO_FUNC_SPI = 1, GPIO_FUNC_I2C = 3, GPIO_FUNC_SIO = 5 };
+
+// Relógio simulado, avançado pelos testes
+extern uint64_t teste_tempo_us;
+
+static inline uint64_t time_us_64(void) { return teste_tempo_us; }
+static inline uint32_t time_us_32(void) { return (uint32_t)teste_tempo_us; }
+static inline absolute_time_t get_absolute_time(void) { return teste_tempo_us; }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline void sleep_us(uint64_t us) { teste_tempo_us += us; }
+static inline void sleep_ms(uint32_t ms) { teste_tempo_us += ms * 1000ull; }
+static inline void tight_loop_contents(void) {}
+
+static inline void gpio_init(uint pino) { (void)pino; }
+static inline void gpio_set_dir(uint pino, bool saida) { (void)pino; (void)saida; }
+static inline void gpio_set_function(uint pino, enum gpio_function f) { (void)pino; (void)f; }
+static inline void gpio_pull_up(uint pino) { (void)pino; }
+static inline bool gpio_get(uint pino) { (void)pino; return true; }
+static inline uint32_t gpio_get_irq_event_mask(uint pino) { (void)pino; return 0; }
+static inline void gpio_acknowledge_irq(uint pino, uint32_t eventos) { (void)pino; (void)eventos; }
+static inline void gpio_set_irq_enabled(uint pino, uint32_t eventos, bool ligado) {
+    (void)pino; (void)eventos; (void)ligado;
+}
+static inline void gpio_add_raw_irq_handler(uint pino, void (*tratador)(void)) {
+    (void)pino; (void)tratador;
+}
+
+// Chip select e demais saídas: registrados pelo teste
+void gpio_put(uint pino, bool valor);
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef TESTE_H
+#define TESTE_H
+
+// Verificações dos testes de host: cada falha é impressa com a linha e
+// contada; o main retorna teste_resultado() (0 = tudo passou).
+#include <stdio.h>
+
+static int teste_falhas = 0;
+
+#define VERIFICAR(cond) do {                                              \
+        if (!(cond)) {                                                    \
+            printf("FALHA|%s:%d|%s\n", __FILE__, __LINE__, #cond);        \
+            teste_falhas++;                                               \
+        }                                                                 \
+    } while (0)
+
+// |a - b| <= tol, com os valores na mensagem
+#define VERIFICAR_PROXIMO(a, b, tol) do {                                 \
+        double va_ = (a), vb_ = (b);                                      \
+        if (!(va_ - vb_ <= (tol) && vb_ - va_ <= (tol))) {                \
+            printf("FALHA|%s:%d|%s = %.9g, %s = %.9g, tol %.3g\n",        \
+                   __FILE__, __LINE__, #a, va_, #b, vb_, (double)(tol));  \
+            teste_falhas++;                                               \
+        }                                                                 \
+    } while (0)
+
+static inline int teste_resultado(const char *nome) {
+    printf("TESTE|%s|%s\n", nome, teste_falhas ? "falhou" : "ok");
+    return teste_falhas != 0;
+}
+
+#endif
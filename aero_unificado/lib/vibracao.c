@@ -0,0 +1,172 @@
+#include "vibracao.h"
+#include <stdio.h>
+#include <math.h>
+#include "matematica_rapida.h"
+#include "codigo_ram.h"
+
+static const float bordas_banda_hz[VIBRACAO_BANDAS] = { 1.0f, 10.0f, 30.0f, 80.0f };
+
+static float janela_hann[VIBRACAO_N];
+static float twiddle_cos[VIBRACAO_N / 2];
+static float twiddle_sen[VIBRACAO_N / 2];
+static uint16_t bin_banda[VIBRACAO_BANDAS + 1];  // Primeiro bin de cada banda
+static float taxa_amostragem;
+static float escala_potencia;    // Soma de |X|² de um lado -> média quadrática
+static float escala_amplitude;   // |X| -> amplitude de pico
+
+static float captura[3][VIBRACAO_N];
+static uint16_t amostras_capturadas = 0;
+static uint8_t eixo_atual = 0;
+static uint32_t janelas = 0;
+
+// Área de trabalho da FFT; depois da transformada, re guarda |X|²
+static float fft_re[VIBRACAO_N];
+static float fft_im[VIBRACAO_N];
+
+void vibracao_inicializar(float taxa_hz) {
+    float soma_w = 0.0f, soma_w2 = 0.0f;
+    for (int n = 0; n < VIBRACAO_N; n++) {
+        janela_hann[n] = 0.5f - 0.5f * cosf(2.0f * MAT_PI * n / VIBRACAO_N);
+        soma_w += janela_hann[n];
+        soma_w2 += janela_hann[n] * janela_hann[n];
+    }
+    for (int k = 0; k < VIBRACAO_N / 2; k++) {
+        twiddle_cos[k] = cosf(2.0f * MAT_PI * k / VIBRACAO_N);
+        twiddle_sen[k] = sinf(2.0f * MAT_PI * k / VIBRACAO_N);
+    }
+
+    // Parseval com janela: os dois lados do espectro entram na soma
+    escala_potencia = 2.0f / (VIBRACAO_N * soma_w2);
+    escala_amplitude = 2.0f / soma_w;
+
+    taxa_amostragem = taxa_hz;
+    for (int b = 0; b < VIBRACAO_BANDAS; b++) {
+        float bin = ceilf(bordas_banda_hz[b] * VIBRACAO_N / taxa_hz);
+        bin_banda[b] = bin < 1.0f ? 1 : bin > VIBRACAO_N / 2 ? VIBRACAO_N / 2 + 1 : (uint16_t)bin;
+    }
+    bin_banda[VIBRACAO_BANDAS] = VIBRACAO_N / 2 + 1;
+
+    amostras_capturadas = 0;
+    eixo_atual = 0;
+    janelas = 0;
+}
+
+void AERO_RAM_FUNC(vibracao_adicionar)(const float aceleracao[3]) {
+    if (amostras_capturadas >= VIBRACAO_N) return;  // Janela aguardando análise
+    captura[0][amostras_capturadas] = aceleracao[0];
+    captura[1][amostras_capturadas] = aceleracao[1];
+    captura[2][amostras_capturadas] = aceleracao[2];
+    amostras_capturadas++;
+}
+
+static void AERO_RAM_FUNC(fft_radix2)(float *re, float *im) {
+    // Permutação por inversão de bits
+    for (int i = 1, j = 0; i < VIBRACAO_N; i++) {
+        int bit = VIBRACAO_N >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    // Borboletas, W = cos - j sen
+    for (int tamanho = 2; tamanho <= VIBRACAO_N; tamanho <<= 1) {
+        int metade = tamanho >> 1;
+        int passo = VIBRACAO_N / tamanho;
+        for (int inicio = 0; inicio < VIBRACAO_N; inicio += tamanho) {
+            for (int k = 0; k < metade; k++) {
+                float wr = twiddle_cos[k * passo];
+                float wi = -twiddle_sen[k * passo];
+                int a = inicio + k, b = a + metade;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+// Insere o bin k entre os maiores picos, mantendo a ordem decrescente
+static void registrar_pico(vibracao_pico_t *picos, const float *potencia, int k) {
+    float a = mat_sqrt(potencia[k - 1]);
+    float b = mat_sqrt(potencia[k]);
+    float c = mat_sqrt(potencia[k + 1]);
+    float amplitude = b * escala_amplitude;
+    if (amplitude <= picos[VIBRACAO_PICOS - 1].amplitude) return;
+
+    // Interpolação parabólica da posição do máximo entre os bins
+    float denominador = a - 2.0f * b + c;
+    float delta = denominador != 0.0f ? 0.5f * (a - c) / denominador : 0.0f;
+
+    int i = VIBRACAO_PICOS - 1;
+    for (; i > 0 && amplitude > picos[i - 1].amplitude; i--) picos[i] = picos[i - 1];
+    picos[i].freq_hz = (k + delta) * taxa_amostragem / VIBRACAO_N;
+    picos[i].amplitude = amplitude;
+}
+
+static void AERO_RAM_FUNC(analisar_eixo)(const float *x, vibracao_eixo_t *eixo) {
+    float media = 0.0f;
+    for (int n = 0; n < VIBRACAO_N; n++) media += x[n];
+    media /= VIBRACAO_N;
+
+    for (int n = 0; n < VIBRACAO_N; n++) {
+        fft_re[n] = (x[n] - media) * janela_hann[n];
+        fft_im[n] = 0.0f;
+    }
+    fft_radix2(fft_re, fft_im);
+
+    for (int k = 0; k <= VIBRACAO_N / 2; k++) {
+        fft_re[k] = fft_re[k] * fft_re[k] + fft_im[k] * fft_im[k];
+    }
+    const float *potencia = fft_re;
+
+    float total = 0.0f;
+    for (int b = 0; b < VIBRACAO_BANDAS; b++) {
+        float soma = 0.0f;
+        for (int k = bin_banda[b]; k < bin_banda[b + 1]; k++) soma += potencia[k];
+        eixo->rms_banda[b] = mat_sqrt(soma * escala_potencia);
+        total += soma;
+    }
+    eixo->rms = mat_sqrt(total * escala_potencia);
+
+    for (int i = 0; i < VIBRACAO_PICOS; i++) {
+        eixo->picos[i].freq_hz = 0.0f;
+        eixo->picos[i].amplitude = 0.0f;
+    }
+    for (int k = 2; k < VIBRACAO_N / 2; k++) {
+        if (potencia[k] > potencia[k - 1] && potencia[k] >= potencia[k + 1]) {
+            registrar_pico(eixo->picos, potencia, k);
+        }
+    }
+}
+
+bool vibracao_processar(vibracao_resultado_t *resultado) {
+    if (amostras_capturadas < VIBRACAO_N) return false;
+
+    analisar_eixo(captura[eixo_atual], &resultado->eixo[eixo_atual]);
+    if (++eixo_atual < 3) return false;
+
+    eixo_atual = 0;
+    resultado->janelas = ++janelas;
+    amostras_capturadas = 0;
+    return true;
+}
+
+void vibracao_imprimir(const vibracao_resultado_t *resultado) {
+    for (int e = 0; e < 3; e++) {
+        const vibracao_eixo_t *eixo = &resultado->eixo[e];
+        printf("VIB|%c|%lu|%.3f", 'X' + e, (unsigned long)resultado->janelas, (double)eixo->rms);
+        for (int i = 0; i < VIBRACAO_PICOS; i++) {
+            printf("|%.1f|%.3f", (double)eixo->picos[i].freq_hz, (double)eixo->picos[i].amplitude);
+        }
+        for (int b = 0; b < VIBRACAO_BANDAS; b++) {
+            printf("|%.3f", (double)eixo->rms_banda[b]);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef VIBRACAO_H
+#define VIBRACAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Espectro de vibração do acelerômetro: janelas de VIBRACAO_N amostras da
+// IMU na taxa cheia, janela de Hann e FFT radix-2 em float, in-place, com
+// tabela de twiddles calculada na inicialização. A resolução é
+// taxa / VIBRACAO_N (~2 Hz a 500 Hz). O DLPF do MPU6500 (44.8 Hz no
+// acelerômetro) atenua o que estiver acima disso.
+#define VIBRACAO_N 256              // Potência de 2
+#define VIBRACAO_PICOS 3
+#define VIBRACAO_BANDAS 4           // 1-10, 10-30, 30-80 Hz e 80 Hz-Nyquist
+
+typedef struct {
+    float freq_hz;     // Interpolada entre os bins vizinhos
+    float amplitude;   // m/s² de pico
+} vibracao_pico_t;
+
+typedef struct {
+    float rms;                              // m/s², sem a média (gravidade)
+    vibracao_pico_t picos[VIBRACAO_PICOS];  // Do maior para o menor
+    float rms_banda[VIBRACAO_BANDAS];
+} vibracao_eixo_t;
+
+typedef struct {
+    uint32_t janelas;
+    vibracao_eixo_t eixo[3];
+} vibracao_resultado_t;
+
+// Tabelas da janela, twiddles e limites das bandas para a taxa da IMU
+void vibracao_inicializar(float taxa_hz);
+
+// Caminho de cada amostra: só copia para a janela em captura (m/s²)
+void vibracao_adicionar(const float aceleracao[3]);
+
+// Trabalho em ciclos livres: com uma janela completa, analisa um eixo por
+// chamada. Retorna true quando os três eixos da janela ficaram prontos em
+// 'resultado'; a captura da janela seguinte recomeça em seguida.
+bool vibracao_processar(vibracao_resultado_t *resultado);
+
+// VIB|eixo|janelas|rms|f1|a1|f2|a2|f3|a3|rms_b0|rms_b1|rms_b2|rms_b3
+void vibracao_imprimir(const vibracao_resultado_t *resultado);
+
+#endif